@@ -0,0 +1,283 @@
+#include "answerindex.h"
+#include <omkit/solution.h>
+#include <omkit/html_utils.h>
+#include <QDataStream>
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QSet>
+#include <QtConcurrent>
+#include <cmath>
+
+namespace {
+const quint32 INDEX_MAGIC = 0x4F4D4149;
+// Bumped when the terms of an answer change, e.g. with htmlToPlainText()
+const qint32 INDEX_VERSION = 2;
+const int MIN_TERM_SIZE = 2;
+// A term that only starts with a query word weighs less than the word itself
+const double PREFIX_WEIGHT = 0.5;
+
+struct AnswerFile {
+    AnswerIndex::AnswerKey key;
+    QString path;
+    QString stamp;
+};
+
+QString makeStamp(const Answer& answer, QString path)
+{
+    QString stamp = QString::number(answer.version) + ":" + answer.hash;
+    // Without the hash the content can change under the same version
+    if (answer.hash.isEmpty()) {
+        QFileInfo fileInfo(path);
+        stamp += QString(":%1:%2").arg(fileInfo.size())
+                .arg(fileInfo.lastModified().toMSecsSinceEpoch());
+    }
+    return stamp;
+}
+
+struct TermCounter {
+    typedef QHash<QString, int> result_type;
+
+    QHash<QString, int> operator()(const AnswerFile& file) const
+    {
+        QHash<QString, int> termCounts;
+        foreach (const auto& term, AnswerIndex::tokenize(htmlToPlainText(readHTML(file.path)))) {
+            if (term.size() >= MIN_TERM_SIZE)
+                termCounts[term]++;
+        }
+        return termCounts;
+    }
+};
+} // namespace
+
+bool operator==(const AnswerIndex::AnswerKey& key1, const AnswerIndex::AnswerKey& key2)
+{
+    return key1.userName == key2.userName && key1.sectionId == key2.sectionId
+            && key1.caseId == key2.caseId;
+}
+
+uint qHash(const AnswerIndex::AnswerKey& key, uint seed)
+{
+    return qHash(key.userName, seed) ^ qHash(key.sectionId, seed) ^ qHash(key.caseId, seed);
+}
+
+AnswerIndex::AnswerIndex(QString path)
+    : path(path)
+{}
+
+bool AnswerIndex::read()
+{
+    QMutexLocker locker(&mutex);
+    docs.clear();
+    freeDocIds.clear();
+    docIds.clear();
+    postings.clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    qint32 version, docsNum;
+    stream >> magic >> version >> docsNum;
+    if (magic != INDEX_MAGIC || version != INDEX_VERSION || docsNum < 0)
+        return false;
+
+    for (int i = 0; i < docsNum; ++i) {
+        Doc doc;
+        stream >> doc.key.userName >> doc.key.sectionId >> doc.key.caseId
+               >> doc.stamp >> doc.termCounts;
+        if (stream.status() != QDataStream::Ok) {
+            docs.clear();
+            docIds.clear();
+            postings.clear();
+            return false;
+        }
+        addDoc(doc);
+    }
+    return true;
+}
+
+bool AnswerIndex::write() const
+{
+    QMutexLocker locker(&mutex);
+    // A cut off index would be read as empty and rebuilt from scratch
+    QSaveFile file(path);
+    file.setDirectWriteFallback(true);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << INDEX_MAGIC << INDEX_VERSION << static_cast<qint32>(docIds.size());
+    foreach (int docId, docIds) {
+        const auto& doc = docs[docId];
+        stream << doc.key.userName << doc.key.sectionId << doc.key.caseId
+               << doc.stamp << doc.termCounts;
+    }
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+bool AnswerIndex::update(const QList<Solution>& solutions)
+{
+    QList<AnswerFile> files;
+    foreach (const auto& solution, solutions) {
+        QDir dir = solution.dir();
+        foreach (const auto& answer, solution.answers()) {
+            if (!answer.isFinal())
+                continue;
+            AnswerFile file;
+            file.key = AnswerKey{ solution.userName, solution.sectionId, answer.caseId };
+            file.path = dir.absoluteFilePath(answer.fileName);
+            file.stamp = makeStamp(answer, file.path);
+            files.append(file);
+        }
+    }
+
+    QList<AnswerFile> changedFiles;
+    QList<int> removedDocIds;
+    {
+        QMutexLocker locker(&mutex);
+        QSet<AnswerKey> foundKeys;
+        foreach (const auto& file, files) {
+            foundKeys.insert(file.key);
+            auto it = docIds.constFind(file.key);
+            if (it == docIds.cend() || docs[it.value()].stamp != file.stamp)
+                changedFiles.append(file);
+        }
+        for (auto it = docIds.cbegin(); it != docIds.cend(); ++it) {
+            if (!foundKeys.contains(it.key()))
+                removedDocIds.append(it.value());
+        }
+    }
+    if (changedFiles.isEmpty() && removedDocIds.isEmpty())
+        return false;
+
+    // Reading and parsing is the slow part, the index stays searchable
+    auto termCounts = QtConcurrent::blockingMapped<QList<QHash<QString, int>>>(
+                changedFiles, TermCounter());
+
+    QMutexLocker locker(&mutex);
+    foreach (int docId, removedDocIds)
+        removeDoc(docId);
+    for (int i = 0; i < changedFiles.size(); ++i) {
+        const auto& file = changedFiles[i];
+        auto it = docIds.constFind(file.key);
+        if (it != docIds.cend())
+            removeDoc(it.value());
+        addDoc(Doc{ file.key, file.stamp, termCounts[i] });
+    }
+    return true;
+}
+
+QList<AnswerIndex::Hit> AnswerIndex::search(QString query, int maxHitsNum) const
+{
+    QList<Hit> hits;
+    auto words = tokenize(query);
+    if (words.isEmpty())
+        return hits;
+
+    QMutexLocker locker(&mutex);
+    double docsNum = docIds.size();
+    QHash<int, double> scores;
+    for (int i = 0; i < words.size(); ++i) {
+        const auto& word = words[i];
+        QHash<int, double> wordScores;
+        for (auto it = postings.lowerBound(word);
+             it != postings.cend() && it.key().startsWith(word); ++it) {
+            double weight = std::log(1.0 + docsNum / it->size());
+            if (it.key().size() != word.size())
+                weight *= PREFIX_WEIGHT;
+            for (auto postingIt = it->cbegin(); postingIt != it->cend(); ++postingIt)
+                wordScores[postingIt.key()] += weight * (1.0 + std::log(postingIt.value()));
+        }
+
+        if (i == 0) {
+            scores.swap(wordScores);
+        } else {
+            for (auto it = scores.begin(); it != scores.end();) {
+                auto wordIt = wordScores.constFind(it.key());
+                if (wordIt == wordScores.cend()) {
+                    it = scores.erase(it);
+                } else {
+                    it.value() += wordIt.value();
+                    ++it;
+                }
+            }
+        }
+        if (scores.isEmpty())
+            return hits;
+    }
+
+    hits.reserve(scores.size());
+    for (auto it = scores.cbegin(); it != scores.cend(); ++it)
+        hits.append(Hit{ docs[it.key()].key, it.value() });
+    qSort(hits.begin(), hits.end(), [](const Hit& hit1, const Hit& hit2) {
+        return hit1.score > hit2.score;
+    });
+    if (hits.size() > maxHitsNum)
+        hits.erase(hits.begin() + maxHitsNum, hits.end());
+    return hits;
+}
+
+int AnswerIndex::answersNum() const
+{
+    QMutexLocker locker(&mutex);
+    return docIds.size();
+}
+
+QStringList AnswerIndex::tokenize(QString text)
+{
+    QStringList result;
+    text = text.toLower();
+    text.replace(QChar(0x0451), QChar(0x0435)); // ё -> е
+    int start = -1;
+    for (int i = 0; i <= text.size(); ++i) {
+        bool isWordChar = i < text.size() && text[i].isLetterOrNumber();
+        if (isWordChar && start == -1) {
+            start = i;
+        } else if (!isWordChar && start != -1) {
+            result.append(text.mid(start, i - start));
+            start = -1;
+        }
+    }
+    return result;
+}
+
+int AnswerIndex::addDoc(const Doc& doc)
+{
+    int docId;
+    if (freeDocIds.isEmpty()) {
+        docId = docs.size();
+        docs.append(doc);
+    } else {
+        docId = freeDocIds.takeLast();
+        docs[docId] = doc;
+    }
+    docIds[doc.key] = docId;
+    for (auto it = doc.termCounts.cbegin(); it != doc.termCounts.cend(); ++it)
+        postings[it.key()][docId] = it.value();
+    return docId;
+}
+
+void AnswerIndex::removeDoc(int docId)
+{
+    auto& doc = docs[docId];
+    for (auto it = doc.termCounts.cbegin(); it != doc.termCounts.cend(); ++it) {
+        auto postingsIt = postings.find(it.key());
+        if (postingsIt == postings.end())
+            continue;
+        postingsIt->remove(docId);
+        if (postingsIt->isEmpty())
+            postings.erase(postingsIt);
+    }
+    docIds.remove(doc.key);
+    doc = Doc();
+    freeDocIds.append(docId);
+}
@@ -0,0 +1,70 @@
+#ifndef ANSWERINDEX_H
+#define ANSWERINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QStringList>
+#include <QUuid>
+#include <QVector>
+
+class Solution;
+
+// Inverted index over the plain text of the final answers of all solutions.
+// It is updated incrementally: only answers whose version, hash or file
+// changed are read again. Terms are lowercased and "ё" is folded to "е",
+// so the search is case-insensitive in Cyrillic too.
+class AnswerIndex
+{
+public:
+    struct AnswerKey {
+        QString userName;
+        QUuid sectionId;
+        QUuid caseId;
+    };
+
+    struct Hit {
+        AnswerKey key;
+        double score;
+    };
+
+    explicit AnswerIndex(QString path);
+
+    bool read();
+    bool write() const;
+    // Returns true if some answer was indexed or removed. May run on a
+    // worker thread while the index is searched.
+    bool update(const QList<Solution>& solutions);
+    // Every word of the query is a prefix of some term of the answer.
+    // Hits are sorted by descending score.
+    QList<Hit> search(QString query, int maxHitsNum) const;
+    int answersNum() const;
+
+    static QStringList tokenize(QString text);
+
+    QString path;
+
+private:
+    struct Doc {
+        AnswerKey key;
+        QString stamp;
+        QHash<QString, int> termCounts;
+    };
+
+    int addDoc(const Doc& doc);
+    void removeDoc(int docId);
+
+    mutable QMutex mutex;
+    QVector<Doc> docs;
+    QList<int> freeDocIds;
+    QHash<AnswerKey, int> docIds;
+    // Sorted, so the terms with a prefix are a contiguous range
+    QMap<QString, QHash<int, int>> postings;
+};
+
+bool operator==(const AnswerIndex::AnswerKey& key1, const AnswerIndex::AnswerKey& key2);
+uint qHash(const AnswerIndex::AnswerKey& key, uint seed);
+
+#endif // ANSWERINDEX_H
@@ -0,0 +1,155 @@
+#include "answersearchform.h"
+#include "answerindex.h"
+#include "section_utils.h"
+#include "solution_utils.h"
+#include "settings.h"
+#include "ui_answersearchform.h"
+#include <QMessageBox>
+#include <QtConcurrent>
+
+namespace {
+const int MAX_HITS_NUM = 500;
+
+enum Role {
+    SectionIdRole = Qt::UserRole,
+    UserNameRole,
+    CaseIdRole
+};
+
+bool updateAndWrite(AnswerIndex* index, const QList<Solution>& solutions)
+{
+    if (!index->update(solutions))
+        return false;
+    index->write();
+    return true;
+}
+}
+
+AnswerSearchForm::AnswerSearchForm(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::AnswerSearchForm),
+    index(new AnswerIndex(QString())),
+    updateWatcher(new QFutureWatcher<bool>(this)),
+    isUpdateRequested(false)
+{
+    ui->setupUi(this);
+    ui->resultsWidget->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    connect(updateWatcher, SIGNAL(finished()), this, SLOT(onIndexUpdated()));
+}
+
+AnswerSearchForm::~AnswerSearchForm()
+{
+    // The index is used by the worker until the update ends
+    updateWatcher->waitForFinished();
+    delete index;
+    delete ui;
+}
+
+void AnswerSearchForm::load()
+{
+    updateWatcher->waitForFinished();
+    index->path = Settings::instance().localAnswerIndexPath();
+    index->read();
+    updateStatus();
+}
+
+void AnswerSearchForm::updateIndex()
+{
+    if (index->path.isEmpty())
+        return;
+    if (updateWatcher->isRunning()) {
+        isUpdateRequested = true;
+        return;
+    }
+    isUpdateRequested = false;
+    updateWatcher->setFuture(QtConcurrent::run(updateAndWrite, index, getSolutions()));
+    updateStatus();
+}
+
+void AnswerSearchForm::showEvent(QShowEvent* event)
+{
+    QWidget::showEvent(event);
+    updateIndex();
+}
+
+void AnswerSearchForm::onIndexUpdated()
+{
+    if (isUpdateRequested) {
+        updateIndex();
+        return;
+    }
+    updateStatus();
+    if (updateWatcher->result() && !ui->queryEdit->text().trimmed().isEmpty())
+        on_searchButton_clicked();
+}
+
+void AnswerSearchForm::on_searchButton_clicked()
+{
+    ui->resultsWidget->setRowCount(0);
+    auto hits = index->search(ui->queryEdit->text(), MAX_HITS_NUM);
+
+    const auto& sections = getSections();
+    int row = 0;
+    ui->resultsWidget->setRowCount(hits.size());
+    foreach (const auto& hit, hits) {
+        auto sectionIt = sections.constFind(hit.key.sectionId);
+        if (sectionIt == sections.cend())
+            continue;
+        const auto& section = sectionIt.value();
+        int caseIndex = 0;
+        while (caseIndex < section.cases.size() && section.cases[caseIndex].id != hit.key.caseId)
+            ++caseIndex;
+        if (caseIndex == section.cases.size())
+            continue;
+
+        QTableWidgetItem* sectionItem = new QTableWidgetItem(section.name);
+        sectionItem->setData(SectionIdRole, section.id);
+        sectionItem->setData(UserNameRole, hit.key.userName);
+        sectionItem->setData(CaseIdRole, hit.key.caseId);
+        ui->resultsWidget->setItem(row, 0, sectionItem);
+        ui->resultsWidget->setItem(row, 1, new QTableWidgetItem(
+                                       QString("%1. %2").arg(caseIndex + 1)
+                                       .arg(section.cases[caseIndex].name)));
+        ui->resultsWidget->setItem(row, 2, new QTableWidgetItem(hit.key.userName));
+        ++row;
+    }
+    ui->resultsWidget->setRowCount(row);
+    updateStatus();
+    if (!ui->queryEdit->text().trimmed().isEmpty())
+        ui->statusLabel->setText(ui->statusLabel->text() + QString(" Найдено ответов: %1.").arg(row));
+}
+
+void AnswerSearchForm::on_queryEdit_returnPressed()
+{
+    on_searchButton_clicked();
+}
+
+void AnswerSearchForm::on_resultsWidget_doubleClicked(const QModelIndex &modelIndex)
+{
+    auto item = ui->resultsWidget->item(modelIndex.row(), 0);
+    if (!item)
+        return;
+    auto sectionId = item->data(SectionIdRole).toUuid();
+    auto userName = item->data(UserNameRole).toString();
+    auto caseId = item->data(CaseIdRole).toUuid();
+    auto solution = getSolution(userName, sectionId);
+    const auto& section = getSections()[sectionId];
+    int caseIndex = 0;
+    while (caseIndex < section.cases.size() && section.cases[caseIndex].id != caseId)
+        ++caseIndex;
+    if (!solution.isValid() || caseIndex == section.cases.size()) {
+        QMessageBox::warning(this, "Ошибка при открытии",
+                             "Невозможно открыть выбранное решение.");
+        return;
+    }
+    emit requestedOpen(solution, caseIndex);
+}
+
+void AnswerSearchForm::updateStatus()
+{
+    if (updateWatcher->isRunning()) {
+        ui->statusLabel->setText("Индексация ответов...");
+    } else {
+        ui->statusLabel->setText(QString("Ответов в индексе: %1.").arg(index->answersNum()));
+    }
+}
@@ -0,0 +1,49 @@
+#ifndef ANSWERSEARCHFORM_H
+#define ANSWERSEARCHFORM_H
+
+#include <QWidget>
+#include <QFutureWatcher>
+
+namespace Ui {
+class AnswerSearchForm;
+}
+
+class AnswerIndex;
+class Solution;
+
+class AnswerSearchForm : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit AnswerSearchForm(QWidget *parent = 0);
+    ~AnswerSearchForm();
+
+    void load();
+
+signals:
+    void requestedOpen(const Solution& solution, int caseIndex);
+
+public slots:
+    // Indexes the answers changed since the last update in background
+    void updateIndex();
+
+protected:
+    void showEvent(QShowEvent* event) override;
+
+private slots:
+    void onIndexUpdated();
+    void on_searchButton_clicked();
+    void on_queryEdit_returnPressed();
+    void on_resultsWidget_doubleClicked(const QModelIndex &modelIndex);
+
+private:
+    void updateStatus();
+
+    Ui::AnswerSearchForm *ui;
+    AnswerIndex* index;
+    QFutureWatcher<bool>* updateWatcher;
+    bool isUpdateRequested;
+};
+
+#endif // ANSWERSEARCHFORM_H
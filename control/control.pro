@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -24,6 +24,13 @@ SOURCES += main.cpp\
     solutionsform.cpp \
     section_utils.cpp \
     solution_utils.cpp \
+    solutionwatcher.cpp \
+    solutionsmodel.cpp \
+    solutionsfiltermodel.cpp \
+    solutionindex.cpp \
+    answerindex.cpp \
+    answersearchform.cpp \
+    solutionimporter.cpp \
     solutionexplorer.cpp \
     answerpage.cpp \
     textexplorer.cpp \
@@ -40,6 +47,13 @@ HEADERS  += mainwindow.h \
     solutionsform.h \
     section_utils.h \
     solution_utils.h \
+    solutionwatcher.h \
+    solutionsmodel.h \
+    solutionsfiltermodel.h \
+    solutionindex.h \
+    answerindex.h \
+    answersearchform.h \
+    solutionimporter.h \
     solutionexplorer.h \
     answerpage.h \
     textexplorer.h \
@@ -53,6 +67,7 @@ HEADERS  += mainwindow.h \
 FORMS    += mainwindow.ui \
     settingsdialog.ui \
     solutionsform.ui \
+    answersearchform.ui \
     solutionexplorer.ui \
     answerpage.ui \
     textexplorer.ui \
@@ -2,6 +2,7 @@
 #include "settingsdialog.h"
 #include "solutionsform.h"
 #include "groupsform.h"
+#include "answersearchform.h"
 #include "solutionexplorer.h"
 #include "trainingcreationwizard.h"
 #include "section_utils.h"
@@ -10,13 +11,16 @@
 #include "settings.h"
 #include "settingswizard.h"
 #include "aboutdialog.h"
+#include "solutionimporter.h"
 #include "ui_mainwindow.h"
 #include <omkit/omkit.h>
+#include <omkit/dirwalker.h>
 #include <omkit/utils.h>
 #include <omkit/string_utils.h>
 #include <omkit/ui_utils.h>
 #include <omkit/solution.h>
 #include <QMessageBox>
+#include <QProgressDialog>
 #include <QTimer>
 #include <QStringList>
 #include <QFileDialog>
@@ -55,6 +59,13 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(settingsDialog, SIGNAL(groupsPathChanged()),
             groupsForm, SLOT(onGroupsPathChanged()));
 
+    answerSearchForm = new AnswerSearchForm(this);
+    tabIndex = ui->tabWidget->addTab(answerSearchForm, "Поиск по ответам");
+    ui->tabWidget->tabBar()->setTabButton(tabIndex, QTabBar::LeftSide, nullptr);
+    ui->tabWidget->tabBar()->setTabButton(tabIndex, QTabBar::RightSide, nullptr);
+    connect(answerSearchForm, SIGNAL(requestedOpen(Solution,int)),
+            this, SLOT(openSolutionCase(Solution,int)));
+
     trainingCreationWizard = new TrainingCreationWizard(this);
     trainingCreationWizard->hide();
 
@@ -64,6 +75,12 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(trainingCreationWizard, SIGNAL(groupCreationRequested()),
             groupsForm, SLOT(createGroup()));
 
+    solutionImporter = new SolutionImporter(this);
+    connect(solutionImporter, SIGNAL(archiveImported(QString,int,int)),
+            this, SLOT(onSolutionArchiveImported(QString,int,int)));
+    connect(solutionImporter, SIGNAL(finished()),
+            this, SLOT(onSolutionsImportFinished()));
+
     QTimer::singleShot(0, this, SLOT(loadSettings()));
 }
 
@@ -87,9 +104,20 @@ void MainWindow::loadSettings()
     loadGroups();
     groupsForm->load();
     solutionsForm->reload();
+    answerSearchForm->load();
 }
 
 void MainWindow::openSolution(const Solution& solution)
+{
+    addSolutionExplorer(solution);
+}
+
+void MainWindow::openSolutionCase(const Solution& solution, int caseIndex)
+{
+    addSolutionExplorer(solution)->selectCase(caseIndex);
+}
+
+SolutionExplorer* MainWindow::addSolutionExplorer(const Solution& solution)
 {
     SolutionExplorer* solutionExplorer = new SolutionExplorer(this);
     solutionExplorer->setSolution(solution);
@@ -100,6 +128,7 @@ void MainWindow::openSolution(const Solution& solution)
             .arg(trim(solution.userName, 10));
     int tabIndex = ui->tabWidget->addTab(solutionExplorer, tabTitle);
     ui->tabWidget->setCurrentIndex(tabIndex);
+    return solutionExplorer;
 }
 
 void MainWindow::execSettingsWizard()
@@ -120,7 +149,7 @@ void MainWindow::on_settingsAction_triggered()
 void MainWindow::on_tabWidget_tabCloseRequested(int index)
 {
     QWidget* widget = ui->tabWidget->widget(index);
-    if (widget != solutionsForm && widget != groupsForm)
+    if (widget != solutionsForm && widget != groupsForm && widget != answerSearchForm)
         delete widget;
 }
 
@@ -130,6 +159,14 @@ void MainWindow::on_trainingCreationWizardAction_triggered()
     trainingCreationWizard->exec();
 }
 
+void MainWindow::on_rebuildSectionsAction_triggered()
+{
+    solutionsForm->reload(true);
+    QMessageBox::information(this, "Список разделов",
+                             QString("Список разделов составлен заново. Прочитано разделов: %1.")
+                             .arg(getParsedSectionsNum()));
+}
+
 void MainWindow::on_aboutAction_triggered()
 {
     if (!aboutDialog)
@@ -139,17 +176,85 @@ void MainWindow::on_aboutAction_triggered()
 
 void MainWindow::on_importSolutionArchiveAction_triggered()
 {
-    QString path = QFileDialog::getOpenFileName(
-                this, "Путь к архиву", Settings::instance().lastPath, "Архив (*.zip)");
+    QStringList paths = QFileDialog::getOpenFileNames(
+                this, "Пути к архивам", Settings::instance().lastPath, "Архив (*.zip)");
+    if (!paths.isEmpty()) {
+        Settings::instance().updateLastPath(QFileInfo(paths.first()).absolutePath());
+        importSolutionArchives(paths);
+    }
+}
+
+void MainWindow::on_importSolutionFolderAction_triggered()
+{
+    QString path = QFileDialog::getExistingDirectory(
+                this, "Путь к папке с архивами", Settings::instance().lastPath);
     if (!path.isEmpty()) {
-        Settings::instance().updateLastPath(QFileInfo(path).absolutePath());
-        if (!importSolutionsFromArchive(path)) {
+        Settings::instance().updateLastPath(path);
+        auto paths = findFiles(path, ".zip");
+        if (paths.isEmpty()) {
             QMessageBox::warning(this, "Ошибка при загрузке",
-                                 "Не удалось загрузить ответы из указанного архива.");
+                                 "В указанной папке нет архивов с ответами.");
             return;
         }
-        solutionsForm->reload();
+        importSolutionArchives(paths);
+    }
+}
+
+void MainWindow::importSolutionArchives(const QStringList& paths)
+{
+    if (solutionImporter->isRunning())
+        return;
+    ui->importSolutionArchiveAction->setEnabled(false);
+    ui->importSolutionFolderAction->setEnabled(false);
+
+    // The dialog does not block the window, the import goes on in background
+    importProgressDialog = new QProgressDialog(
+                "Загрузка ответов...", "Отмена", 0, paths.size(), this);
+    importProgressDialog->setWindowTitle("Загрузка ответов");
+    importProgressDialog->setAutoClose(false);
+    importProgressDialog->setAutoReset(false);
+    importProgressDialog->setMinimumDuration(0);
+    importProgressDialog->setValue(0);
+    connect(importProgressDialog, SIGNAL(canceled()), solutionImporter, SLOT(cancel()));
+    solutionImporter->start(paths);
+}
+
+void MainWindow::onSolutionArchiveImported(QString path, int doneNum, int totalNum)
+{
+    importProgressDialog->setValue(doneNum);
+    importProgressDialog->setLabelText(QString("Загружено архивов: %1 из %2\n%3")
+                                       .arg(doneNum)
+                                       .arg(totalNum)
+                                       .arg(QFileInfo(path).fileName()));
+}
+
+void MainWindow::onSolutionsImportFinished()
+{
+    importProgressDialog->deleteLater();
+    importProgressDialog = nullptr;
+    ui->importSolutionArchiveAction->setEnabled(true);
+    ui->importSolutionFolderAction->setEnabled(true);
+
+    int totalNum = solutionImporter->totalNum();
+    int importedNum = solutionImporter->importedNum();
+    const auto& failedPaths = solutionImporter->failedPaths();
+    QString text = QString("Загружено архивов: %1 из %2.").arg(importedNum).arg(totalNum);
+    if (!failedPaths.isEmpty()) {
+        QStringList failedNames;
+        foreach (const auto& failedPath, failedPaths)
+            failedNames.append(QFileInfo(failedPath).fileName());
+        text += QString("\n\nНе удалось загрузить ответы из архивов: \n%1")
+                .arg(failedNames.join('\n'));
     }
+    int skippedNum = totalNum - importedNum - failedPaths.size();
+    if (solutionImporter->isCanceled() && skippedNum > 0)
+        text += QString("\n\nЗагрузка отменена, пропущено архивов: %1.").arg(skippedNum);
+
+    solutionsForm->reload();
+    if (importedNum == totalNum)
+        QMessageBox::information(this, "Загрузка ответов", text);
+    else
+        QMessageBox::warning(this, "Загрузка ответов", text);
 }
 
 void MainWindow::on_importSectionFolderAction_triggered()
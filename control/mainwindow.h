@@ -11,9 +11,13 @@ class Solution;
 class SettingsDialog;
 class SolutionsForm;
 class GroupsForm;
+class AnswerSearchForm;
+class SolutionExplorer;
 class TrainingCreationWizard;
 class SettingsWizard;
 class AboutDialog;
+class SolutionImporter;
+class QProgressDialog;
 
 class MainWindow : public QMainWindow
 {
@@ -26,24 +30,35 @@ public:
 private slots:
     void loadSettings();
     void openSolution(const Solution& solution);
+    void openSolutionCase(const Solution& solution, int caseIndex);
     void execSettingsWizard();
     void on_settingsAction_triggered();
     void on_tabWidget_tabCloseRequested(int index);
     void on_trainingCreationWizardAction_triggered();
+    void on_rebuildSectionsAction_triggered();
     void on_aboutAction_triggered();
     void on_importSolutionArchiveAction_triggered();
+    void on_importSolutionFolderAction_triggered();
+    void onSolutionArchiveImported(QString path, int doneNum, int totalNum);
+    void onSolutionsImportFinished();
     void on_importSectionFolderAction_triggered();
     void on_importSectionArchiveAction_triggered();
 
 private:
+    void importSolutionArchives(const QStringList& paths);
+    SolutionExplorer* addSolutionExplorer(const Solution& solution);
+
     Ui::MainWindow *ui;
 
     SettingsDialog* settingsDialog;
     SolutionsForm* solutionsForm;
     GroupsForm* groupsForm;
+    AnswerSearchForm* answerSearchForm;
     TrainingCreationWizard* trainingCreationWizard;
     SettingsWizard* settingsWizard = nullptr;
     AboutDialog* aboutDialog = nullptr;
+    SolutionImporter* solutionImporter;
+    QProgressDialog* importProgressDialog = nullptr;
 };
 
 #endif // MAINWINDOW_H
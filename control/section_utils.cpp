@@ -1,5 +1,6 @@
 #include "section_utils.h"
 #include "settings.h"
+#include <omkit/sectioncatalog.h>
 #include <omkit/utils.h>
 #include <omkit/zip_utils.h>
 #include <QTemporaryDir>
@@ -8,9 +9,13 @@ namespace {
 QHash<QUuid, Section> sections;
 QList<Section> sortedSections;
 QStringList sectionNames;
+int sectionsRevision = 0;
+int cachedSectionsNum = 0;
+int parsedSectionsNum = 0;
 
 void clearSections()
 {
+    sectionsRevision++;
     sections.clear();
     sortedSections.clear();
     sectionNames.clear();
@@ -30,7 +35,7 @@ QStringList saveSections(const QList<Section>& sectionsToSave)
 
         QDir dir(path);
         QString newFilePath = dir.absoluteFilePath(QFileInfo(section.path).fileName());
-        auto importedSection = section.saveAs(newFilePath);
+        auto importedSection = section.saveAs(newFilePath, rootPath);
         if (!importedSection.isValid())
             continue;
 
@@ -45,11 +50,18 @@ QStringList saveSections(const QList<Section>& sectionsToSave)
 }
 }
 
-void loadSections()
+void loadSections(bool forceRebuild)
 {
     clearSections();
 
-    auto sectionList = Section::findAll(Settings::instance().sectionsPath);
+    const auto& settings = Settings::instance();
+    SectionCatalog catalog(settings.localSectionCatalogPath());
+    if (!forceRebuild)
+        catalog.read();
+    auto sectionList = catalog.findAll(settings.sectionsPath, forceRebuild);
+    catalog.write();
+    cachedSectionsNum = catalog.hits();
+    parsedSectionsNum = catalog.misses();
     foreach (const auto& section, sectionList) {
         sections[section.id] = section;
         sectionNames.append(section.name);
@@ -66,6 +78,21 @@ const QHash<QUuid, Section>& getSections()
     return sections;
 }
 
+int getSectionsRevision()
+{
+    return sectionsRevision;
+}
+
+int getCachedSectionsNum()
+{
+    return cachedSectionsNum;
+}
+
+int getParsedSectionsNum()
+{
+    return parsedSectionsNum;
+}
+
 const QList<Section>& getSortedSections()
 {
     return sortedSections;
@@ -106,5 +133,6 @@ bool saveSections()
         return true;
     auto sectionsToSave = sections.values();
     sections.clear();
+    sectionsRevision++;
     return saveSections(sectionsToSave).size() == sectionsToSave.size();
 }
@@ -6,8 +6,15 @@
 #include <QHash>
 #include <QStringList>
 
-void loadSections();
+// Sections are taken from the catalog unless their files have changed.
+// A rebuild throws the catalog away and parses every section file.
+void loadSections(bool forceRebuild = false);
 const QHash<QUuid, Section>& getSections();
+// Changes whenever the sections are reloaded
+int getSectionsRevision();
+// Sections taken from the catalog and parsed by the last loadSections()
+int getCachedSectionsNum();
+int getParsedSectionsNum();
 const QList<Section>& getSortedSections();
 const QStringList& getSectionNames();
 QStringList importSectionsFromFolder(QString path);
@@ -22,6 +22,9 @@ bool Settings::read()
     groupsPath = rootObj["groupsPath"].toString(groupsPath);
     lastPath = rootObj["lastPath"].toString(lastPath);
     isFirstUsage = rootObj["isFirstUsage"].toBool(false);
+    archiveThreadCount = qMax(0, rootObj["archiveThreadCount"].toInt(archiveThreadCount));
+    archiveCompressionLevel = qBound(-1, rootObj["archiveCompressionLevel"]
+                                     .toInt(archiveCompressionLevel), 9);
     return true;
 }
 
@@ -33,6 +36,8 @@ bool Settings::write() const
     rootObj["groupsPath"] = groupsPath;
     rootObj["lastPath"] = lastPath;
     rootObj["isFirstUsage"] = false;
+    rootObj["archiveThreadCount"] = archiveThreadCount;
+    rootObj["archiveCompressionLevel"] = archiveCompressionLevel;
     return writeJSON(SETTINGS_FILE_NAME, rootObj);
 }
 
@@ -66,6 +71,24 @@ QString Settings::localGroupsPath() const
     return dir.absoluteFilePath("Groups.json");
 }
 
+QString Settings::localSectionCatalogPath() const
+{
+    QString path = localDataPath();
+    if (path.isEmpty())
+        return QString();
+    QDir dir(path);
+    return dir.absoluteFilePath("Sections.omsidx");
+}
+
+QString Settings::localAnswerIndexPath() const
+{
+    QString path = localDataPath();
+    if (path.isEmpty())
+        return QString();
+    QDir dir(path);
+    return dir.absoluteFilePath("Answers.omaidx");
+}
+
 bool Settings::isNetworkSupported() const
 {
     return !solutionsPath.isEmpty();
@@ -79,4 +102,6 @@ void Settings::updateLastPath(QString newPath)
 
 Settings::Settings()
     : isFirstUsage(false)
+    , archiveThreadCount(0)
+    , archiveCompressionLevel(-1)
 {}
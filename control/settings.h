@@ -13,6 +13,8 @@ public:
     QString localDataPath() const;
     QString localSolutionsPath() const;
     QString localGroupsPath() const;
+    QString localSectionCatalogPath() const;
+    QString localAnswerIndexPath() const;
     bool isNetworkSupported() const;
     void updateLastPath(QString newPath);
 
@@ -21,6 +23,9 @@ public:
     QString groupsPath;
     QString lastPath;
     bool isFirstUsage;
+    // Passed to ZipBuilder for training packages
+    int archiveThreadCount;
+    int archiveCompressionLevel;
 
 private:
     Settings();
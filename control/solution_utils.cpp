@@ -2,12 +2,17 @@
 #include "settings.h"
 #include "section_utils.h"
 #include "group_utils.h"
+#include <omkit/dirwalker.h>
+#include <omkit/solutionmanifest.h>
 #include <omkit/utils.h>
 #include <omkit/zip_utils.h>
+#include <QDateTime>
+#include <QDir>
 #include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
 #include <QFileInfo>
 #include <QSet>
-#include <QTemporaryDir>
 
 namespace {
 struct SolutionKey {
@@ -29,13 +34,47 @@ QList<Solution> solutions;
 QHash<SolutionKey, Solution> localSolutions;
 QStringList userNames;
 QStringList userNamesWithoutGroup;
+// The change tracking below is guarded by updateMutex, as updates may run
+// on a worker thread
+QMutex updateMutex;
+QHash<QString, QDateTime> remoteStamps;
+// Remote users that keep a manifest are tracked by the time of their
+// marker and the answer versions of their solutions
+QHash<QString, QDateTime> markerStamps;
+QHash<QString, QHash<QUuid, int>> remoteVersions;
+// Stats of the local solutions, valid for the sections of statsRevision
+QHash<SolutionKey, CompletionStats> completionStats;
+int statsRevision = -1;
+
+// Archives are imported on several threads at once. The mutex guards the
+// solution maps, while merges of the same solution are serialized by the
+// mutex of its key, so that the slow part of a merge runs unlocked.
+QMutex solutionsMutex;
+// Kept for the whole session: a merge may still hold one when an import
+// ends, and a new mutex for the same key would not exclude it
+QHash<SolutionKey, QSharedPointer<QMutex>> keyMutexes;
+QHash<SolutionKey, Solution> importedRemoteSolutions;
+// The remote solutions of an import are loaded by its first merge, so the
+// walk of the share does not run on the UI thread
+QMutex remoteLoadMutex;
+bool isRemoteLoadPending = false;
+bool areRemoteSolutionsLoaded = false;
+
+QSharedPointer<QMutex> getKeyMutex(const SolutionKey& key)
+{
+    QMutexLocker locker(&solutionsMutex);
+    auto& mutex = keyMutexes[key];
+    if (!mutex)
+        mutex.reset(new QMutex);
+    return mutex;
+}
 
 QString getUserPath(QString path, QString userName)
 {
     QDir dir(path);
-    if (!dir.exists(userName))
-        if (!dir.mkdir(userName))
-            return QString();
+    // The dir may be created by another import at the same time
+    if (!dir.exists(userName) && !dir.mkdir(userName) && !dir.exists(userName))
+        return QString();
     return dir.absoluteFilePath(userName);
 }
 
@@ -55,22 +94,51 @@ QString makePath(QString rootPath, const Solution& solution)
     return path;
 }
 
-void mergeTo(
+bool isRemoteRoot(QString path)
+{
+    QString rootPath = Settings::instance().solutionsPath;
+    return !rootPath.isEmpty() && QDir(path).absolutePath() == QDir(rootPath).absolutePath();
+}
+
+QString solutionFilePath(const Solution& solution)
+{
+    return QFileInfo(QDir(solution.dirPath).absoluteFilePath(solution.fileName))
+            .absoluteFilePath();
+}
+
+// mergedPaths receives the file paths of the source solutions that are
+// merged or found equal to their destination
+bool mergeTo(
         const QList<Solution>& srcSolutions,
         QHash<SolutionKey, Solution>& dstSolutions,
-        QString dstSolutionsPath)
+        QString dstSolutionsPath,
+        const Solution::AnswerCopier& copyAnswer = copyWithOverwrite,
+        QSet<QString>* mergedPaths = nullptr)
 {
+    bool isRemote = isRemoteRoot(dstSolutionsPath);
+    bool isChanged = false;
     foreach (const auto& solution, srcSolutions) {
         if (!solution.isValid())
             continue;
 
         SolutionKey key{ solution.userName, solution.sectionId };
+        auto keyMutex = getKeyMutex(key);
+        QMutexLocker keyLocker(keyMutex.data());
         Solution dstSolution;
-        if (dstSolutions.contains(key)) {
-            const auto& solutionInMap = dstSolutions[key];
-            if (solutionInMap.isEqual(solution))
+        bool isFound;
+        {
+            QMutexLocker locker(&solutionsMutex);
+            auto it = dstSolutions.constFind(key);
+            isFound = it != dstSolutions.cend();
+            if (isFound)
+                dstSolution = it.value();
+        }
+        if (isFound) {
+            if (dstSolution.isEqual(solution)) {
+                if (mergedPaths)
+                    mergedPaths->insert(solutionFilePath(solution));
                 continue;
-            dstSolution = solutionInMap;
+            }
         } else {
             auto path = makePath(dstSolutionsPath, solution);
             if (path.isEmpty())
@@ -78,19 +146,55 @@ void mergeTo(
             dstSolution = solution.cloneHeader(path);
         }
 
-        if (!dstSolution.merge(solution))
+        // Control writes to the user dirs behind the training app. The
+        // manifest is dropped before the write, which may fail halfway, and
+        // stays dropped until the app rewrites it.
+        if (isRemote)
+            SolutionManifest::invalidate(dstSolutionsPath, solution.userName);
+        if (!dstSolution.merge(solution, copyAnswer))
             continue;
+        if (mergedPaths)
+            mergedPaths->insert(solutionFilePath(solution));
+        QMutexLocker locker(&solutionsMutex);
         dstSolutions[key] = dstSolution;
+        completionStats.remove(key);
+        isChanged = true;
     }
-
+    return isChanged;
 }
 
+struct ArchiveSolutionOpener {
+    typedef Solution result_type;
+
+    Solution operator()(const QString& name) const
+    {
+        QByteArray data;
+        QByteArray journalData;
+        if (!reader->read(name, data))
+            return Solution();
+        if (reader->contains(Solution::journalFileName(name))
+            && !reader->read(Solution::journalFileName(name), journalData))
+            return Solution();
+
+        QFileInfo fileInfo(name);
+        Solution solution;
+        solution.dirPath = fileInfo.path();
+        solution.fileName = fileInfo.fileName();
+        if (!solution.open(data, journalData))
+            return Solution();
+        return solution;
+    }
+
+    const ZipReader* reader;
+};
+
 void updateLists()
 {
     solutions.clear();
     userNames.clear();
     const auto& sections = getSections();
     QSet<QString> userNameSet;
+    QMutexLocker locker(&solutionsMutex);
     for (auto it = localSolutions.cbegin(); it != localSolutions.cend(); ++it) {
         const auto& solution = *it;
         if (!sections.contains(solution.sectionId))
@@ -104,29 +208,225 @@ void updateLists()
     updateUserNamesWithoutGroup();
 }
 
+// A single listing gives the marker times of all users
+QHash<QString, QDateTime> findMarkers(QString rootPath)
+{
+    QHash<QString, QDateTime> result;
+    QDir markerDir(QDir(rootPath).absoluteFilePath(SolutionManifest::DIR_NAME));
+    foreach (const auto& fileInfo, markerDir.entryInfoList(QStringList("*.json"), QDir::Files))
+        result[fileInfo.completeBaseName()] = fileInfo.lastModified();
+    return result;
+}
+
+// Returns false if the manifest can not be trusted and the user dir has to
+// be walked instead. The versions of the changed solutions go to
+// newVersions, to be kept only once the solutions are merged.
+bool findChangedByManifest(QString rootPath, QString userName, QDateTime markerStamp,
+                           QHash<QString, QHash<QUuid, int>>& newVersions,
+                           QStringList& changedPaths)
+{
+    auto it = markerStamps.constFind(userName);
+    if (it != markerStamps.cend() && it.value() == markerStamp)
+        return true;
+
+    SolutionManifest manifest;
+    if (!manifest.read(rootPath, userName))
+        return false;
+    QDir userDir(QDir(rootPath).absoluteFilePath(userName));
+    foreach (const auto& entry, manifest.entries) {
+        QString filePath = userDir.absoluteFilePath(entry.filePath);
+        auto versionsIt = remoteVersions.constFind(filePath);
+        if (versionsIt != remoteVersions.cend() && versionsIt.value() == entry.versions)
+            continue;
+        newVersions[filePath] = entry.versions;
+        changedPaths.append(filePath);
+    }
+    return true;
+}
+
+// The stamps of the changed files go to newStamps, to be kept only once
+// their solutions are merged
+QStringList findChangedByStamps(QString path, QHash<QString, QDateTime>& newStamps)
+{
+    QString journalSuffix = ".omsol" + Solution::JOURNAL_SUFFIX;
+    QSet<QString> foundPaths;
+    QSet<QString> changedPathSet;
+    auto fileInfos = findFileInfos(path, QStringList() << ".omsol" << journalSuffix);
+    foreach (const auto& fileInfo, fileInfos) {
+        QString filePath = fileInfo.filePath();
+        QDateTime lastModified = fileInfo.lastModified();
+        foundPaths.insert(filePath);
+        auto it = remoteStamps.constFind(filePath);
+        if (it != remoteStamps.cend() && it.value() == lastModified)
+            continue;
+        newStamps[filePath] = lastModified;
+        // Appended answers change only the journal of the solution
+        if (filePath.endsWith(journalSuffix, Qt::CaseInsensitive))
+            filePath.chop(Solution::JOURNAL_SUFFIX.size());
+        changedPathSet.insert(filePath);
+    }
+    QStringList changedPaths;
+    foreach (const auto& fileInfo, fileInfos) {
+        if (changedPathSet.contains(fileInfo.filePath()))
+            changedPaths.append(fileInfo.filePath());
+    }
+
+    QString dirPath = QDir(path).absolutePath() + "/";
+    for (auto it = remoteStamps.begin(); it != remoteStamps.end();) {
+        if (it.key().startsWith(dirPath) && !foundPaths.contains(it.key()))
+            it = remoteStamps.erase(it);
+        else
+            ++it;
+    }
+    return changedPaths;
+}
+
+// Paths of all solutions on the share, listing only the dirs of the users
+// without a manifest
+QStringList findRemoteSolutionPaths(QString rootPath)
+{
+    QStringList result;
+    auto markers = findMarkers(rootPath);
+    QDir rootDir(rootPath);
+    foreach (const auto& userName, rootDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        if (userName == SolutionManifest::DIR_NAME)
+            continue;
+        QDir userDir(rootDir.absoluteFilePath(userName));
+        SolutionManifest manifest;
+        if (markers.contains(userName) && manifest.read(rootPath, userName)) {
+            foreach (const auto& entry, manifest.entries)
+                result.append(userDir.absoluteFilePath(entry.filePath));
+        } else {
+            result.append(findFiles(userDir.absolutePath(), ".omsol"));
+        }
+    }
+    return result;
+}
+
 void loadTo(QString path, QHash<SolutionKey, Solution>& dstSolutions)
 {
-    auto solutionList = Solution::findAll(path);
+    auto solutionList = isRemoteRoot(path)
+            ? Solution::openAll(findRemoteSolutionPaths(path))
+            : Solution::findAll(path);
+    QMutexLocker locker(&solutionsMutex);
     foreach (const auto& solution, solutionList) {
         SolutionKey key{ solution.userName, solution.sectionId };
         dstSolutions[key] = solution;
+        completionStats.remove(key);
     }
 }
+
+bool loadImportedRemoteSolutions()
+{
+    QMutexLocker locker(&remoteLoadMutex);
+    if (isRemoteLoadPending) {
+        loadTo(Settings::instance().solutionsPath, importedRemoteSolutions);
+        isRemoteLoadPending = false;
+        areRemoteSolutionsLoaded = true;
+    }
+    return areRemoteSolutionsLoaded;
+}
+
 } // namespace
 
 void loadSolutions()
 {
     const auto& settings = Settings::instance();
     QString localSolutionsPath = settings.localSolutionsPath();
-    if (localSolutions.isEmpty()) {
+    bool isEmpty;
+    {
+        QMutexLocker locker(&solutionsMutex);
+        isEmpty = localSolutions.isEmpty();
+    }
+    if (isEmpty) {
         if (localSolutionsPath.isEmpty())
             return;
         loadTo(localSolutionsPath, localSolutions);
     }
 
     if (!settings.solutionsPath.isEmpty())
-        mergeTo(Solution::findAll(settings.solutionsPath), localSolutions, localSolutionsPath);
+        updateSolutions(settings.solutionsPath);
+
+    updateLists();
+}
+
+bool updateSolutions(QString path)
+{
+    if (!mergeChangedSolutions(path))
+        return false;
+    updateLists();
+    return true;
+}
+
+bool mergeChangedSolutions(QString path)
+{
+    const auto& settings = Settings::instance();
+    QString localSolutionsPath = settings.localSolutionsPath();
+    if (localSolutionsPath.isEmpty())
+        return false;
 
+    QMutexLocker updateLocker(&updateMutex);
+    QStringList changedPaths;
+    QHash<QString, QDateTime> newStamps;
+    QHash<QString, QHash<QUuid, int>> newVersions;
+    QHash<QString, QDateTime> newMarkerStamps;
+    if (isRemoteRoot(path)) {
+        auto markers = findMarkers(path);
+        QDir rootDir(path);
+        foreach (const auto& userName, rootDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            if (userName == SolutionManifest::DIR_NAME)
+                continue;
+            auto it = markers.constFind(userName);
+            if (it != markers.cend()
+                && findChangedByManifest(path, userName, it.value(), newVersions,
+                                         changedPaths)) {
+                newMarkerStamps[userName] = it.value();
+                continue;
+            }
+            markerStamps.remove(userName);
+            changedPaths.append(findChangedByStamps(rootDir.absoluteFilePath(userName),
+                                                    newStamps));
+        }
+    } else {
+        changedPaths = findChangedByStamps(path, newStamps);
+    }
+    if (changedPaths.isEmpty()) {
+        for (auto it = newMarkerStamps.cbegin(); it != newMarkerStamps.cend(); ++it)
+            markerStamps[it.key()] = it.value();
+        return false;
+    }
+
+    QSet<QString> mergedPaths;
+    bool isChanged = mergeTo(Solution::openAll(changedPaths), localSolutions,
+                             localSolutionsPath, copyWithOverwrite, &mergedPaths);
+    // A solution read while it was being written is read again next time
+    for (auto it = newStamps.cbegin(); it != newStamps.cend(); ++it) {
+        QString solutionPath = it.key();
+        if (solutionPath.endsWith(Solution::JOURNAL_SUFFIX, Qt::CaseInsensitive))
+            solutionPath.chop(Solution::JOURNAL_SUFFIX.size());
+        if (mergedPaths.contains(QFileInfo(solutionPath).absoluteFilePath()))
+            remoteStamps[it.key()] = it.value();
+    }
+    // The marker of a user is kept only when all of the user's solutions
+    // are merged, otherwise the manifest is read again next time
+    QSet<QString> usersWithFailures;
+    for (auto it = newVersions.cbegin(); it != newVersions.cend(); ++it) {
+        if (mergedPaths.contains(QFileInfo(it.key()).absoluteFilePath())) {
+            remoteVersions[it.key()] = it.value();
+            continue;
+        }
+        QString relativePath = QDir(path).relativeFilePath(it.key());
+        usersWithFailures.insert(relativePath.section('/', 0, 0));
+    }
+    for (auto it = newMarkerStamps.cbegin(); it != newMarkerStamps.cend(); ++it) {
+        if (!usersWithFailures.contains(it.key()))
+            markerStamps[it.key()] = it.value();
+    }
+    return isChanged;
+}
+
+void updateSolutionLists()
+{
     updateLists();
 }
 
@@ -135,13 +435,26 @@ const QList<Solution>& getSolutions()
     return solutions;
 }
 
-const Solution& getSolution(QString userName, const QUuid& sectionId)
+Solution getSolution(QString userName, const QUuid& sectionId)
 {
-    static const Solution INVALID_SOLUTION;
-    SolutionKey key{ userName, sectionId };
-    if (localSolutions.contains(key))
-        return localSolutions[key];
-    return INVALID_SOLUTION;
+    QMutexLocker locker(&solutionsMutex);
+    return localSolutions.value(SolutionKey{ userName, sectionId });
+}
+
+CompletionStats getCompletionStats(const Solution& solution)
+{
+    QMutexLocker locker(&solutionsMutex);
+    if (statsRevision != getSectionsRevision()) {
+        completionStats.clear();
+        statsRevision = getSectionsRevision();
+    }
+    SolutionKey key{ solution.userName, solution.sectionId };
+    auto it = completionStats.constFind(key);
+    if (it != completionStats.cend())
+        return it.value();
+    auto stats = CompletionStats::make(getSections()[solution.sectionId], solution);
+    completionStats[key] = stats;
+    return stats;
 }
 
 const QStringList& getUserNames()
@@ -149,32 +462,59 @@ const QStringList& getUserNames()
     return userNames;
 }
 
-bool importSolutionsFromArchive(QString path)
+SolutionArchive openSolutionArchive(QString path)
 {
-    if (!QFileInfo(path).isFile())
-        return false;
-
-    QTemporaryDir tempDir;
-    if (!tempDir.isValid())
-        return false;
-
-    if (!extract(path, tempDir.path()))
-        return false;
+    // Solutions are parsed in the archive and only the answers newer than
+    // the merged ones are extracted later, straight to their destination
+    SolutionArchive result;
+    QSharedPointer<ZipReader> reader(new ZipReader(path));
+    if (!reader->open())
+        return result;
+
+    // Archives are opened in parallel, so their solutions are parsed in turn
+    ArchiveSolutionOpener opener{ reader.data() };
+    foreach (const auto& name, reader->fileNames()) {
+        if (!name.endsWith(".omsol", Qt::CaseInsensitive))
+            continue;
+        auto solution = opener(name);
+        if (solution.isValid())
+            result.solutions.append(solution);
+    }
+    if (!result.solutions.isEmpty())
+        result.reader = reader;
+    return result;
+}
 
-    auto newSolutions = Solution::findAll(tempDir.path());
-    if (newSolutions.empty())
+bool mergeSolutionArchive(const SolutionArchive& archive)
+{
+    if (!archive.reader || archive.solutions.isEmpty())
         return false;
-
+    const ZipReader* reader = archive.reader.data();
+    auto copyAnswer = [reader](QString srcPath, QString dstPath) {
+        return reader->extractTo(srcPath, dstPath);
+    };
     const auto& settings = Settings::instance();
-    mergeTo(newSolutions, localSolutions, settings.localSolutionsPath());
-    if (!settings.solutionsPath.isEmpty()) {
-        QHash<SolutionKey, Solution> remoteSolutions;
-        loadTo(settings.solutionsPath, remoteSolutions);
-        mergeTo(newSolutions, remoteSolutions, settings.solutionsPath);
-    }
+    mergeTo(archive.solutions, localSolutions, settings.localSolutionsPath(), copyAnswer);
+    if (loadImportedRemoteSolutions())
+        mergeTo(archive.solutions, importedRemoteSolutions, settings.solutionsPath, copyAnswer);
     return true;
 }
 
+void beginSolutionsImport()
+{
+    QMutexLocker locker(&remoteLoadMutex);
+    isRemoteLoadPending = !Settings::instance().solutionsPath.isEmpty();
+}
+
+void endSolutionsImport()
+{
+    QMutexLocker remoteLoadLocker(&remoteLoadMutex);
+    QMutexLocker locker(&solutionsMutex);
+    importedRemoteSolutions.clear();
+    isRemoteLoadPending = false;
+    areRemoteSolutionsLoaded = false;
+}
+
 const QStringList& getUserNamesWithoutGroup()
 {
     return userNamesWithoutGroup;
@@ -192,15 +532,21 @@ void updateUserNamesWithoutGroup()
 bool changeSolutionAuthor(QString userName, const QUuid& sectionId, QString newUserName)
 {
     SolutionKey key{ userName, sectionId };
-    auto itLocalSolution = localSolutions.find(key);
-    if (itLocalSolution == localSolutions.end())
+    SolutionKey newKey{ newUserName, sectionId };
+    // Merges of the watcher or an import must not write either solution
+    // while its files are moved
+    auto keyMutex = getKeyMutex(key);
+    auto newKeyMutex = getKeyMutex(newKey);
+    QMutexLocker keyLocker(keyMutex.data());
+    QMutexLocker newKeyLocker(newKeyMutex.data());
+    auto localSolution = getSolution(userName, sectionId);
+    if (!localSolution.isValid())
         return false;
     if (getSolution(newUserName, sectionId).isValid())
         return false;
 
     const auto& settings = Settings::instance();
     QString localSolutionsPath = settings.localSolutionsPath();
-    auto localSolution = itLocalSolution.value();
     localSolution.userName = newUserName;
     auto newPath = makePath(localSolutionsPath, localSolution);
     if (!localSolution.moveTo(newPath))
@@ -209,6 +555,8 @@ bool changeSolutionAuthor(QString userName, const QUuid& sectionId, QString newU
         return false;
 
     if (settings.isNetworkSupported()) {
+        SolutionManifest::invalidate(settings.solutionsPath, userName);
+        SolutionManifest::invalidate(settings.solutionsPath, newUserName);
         auto remoteSolutions = Solution::findAll(
                     getUserPath(settings.solutionsPath, userName));
         for (auto& solution : remoteSolutions) {
@@ -221,9 +569,13 @@ bool changeSolutionAuthor(QString userName, const QUuid& sectionId, QString newU
         }
     }
 
-    localSolutions.erase(itLocalSolution);
-    SolutionKey newKey{ newUserName, sectionId };
-    localSolutions[newKey] = localSolution;
+    {
+        QMutexLocker locker(&solutionsMutex);
+        localSolutions.remove(key);
+        completionStats.remove(key);
+        localSolutions[newKey] = localSolution;
+        completionStats.remove(newKey);
+    }
     updateLists();
     return true;
 }
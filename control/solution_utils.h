@@ -2,14 +2,37 @@
 #define SOLUTION_UTILS_H
 
 #include <omkit/solution.h>
+#include <omkit/completionstats.h>
+#include <omkit/zip_utils.h>
 #include <QList>
+#include <QSharedPointer>
 #include <QStringList>
 
 void loadSolutions();
+bool updateSolutions(QString path);
+// The part of updateSolutions() that may run on a worker thread. The lists
+// are then refreshed on the UI thread by updateSolutionLists().
+bool mergeChangedSolutions(QString path);
+void updateSolutionLists();
 const QList<Solution>& getSolutions();
-const Solution& getSolution(QString userName, const QUuid& sectionId);
+Solution getSolution(QString userName, const QUuid& sectionId);
+// Cached until the solution or the sections are reloaded. The solution
+// must be one of getSolutions().
+CompletionStats getCompletionStats(const Solution& solution);
 const QStringList& getUserNames();
-bool importSolutionsFromArchive(QString path);
+// An archive opened and parsed, whose answers are read when it is merged
+struct SolutionArchive {
+    QSharedPointer<ZipReader> reader;
+    QList<Solution> solutions;
+};
+
+// Archives may be opened and merged on several threads at once between
+// beginSolutionsImport() and endSolutionsImport(). The first merge loads
+// the remote solutions that the imported ones are also merged to.
+void beginSolutionsImport();
+SolutionArchive openSolutionArchive(QString path);
+bool mergeSolutionArchive(const SolutionArchive& archive);
+void endSolutionsImport();
 const QStringList& getUserNamesWithoutGroup();
 void updateUserNamesWithoutGroup();
 bool changeSolutionAuthor(QString userName, const QUuid& sectionId,
@@ -25,9 +25,10 @@ public:
 signals:
     void authorRenamed();
 
-private slots:
+public slots:
     void selectCase(int caseIndex);
 
+private slots:
     void on_listWidget_itemSelectionChanged();
     void on_editUserNameButton_clicked();
 
@@ -0,0 +1,178 @@
+#include "solutionimporter.h"
+#include <QFutureWatcher>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QtConcurrent>
+
+namespace {
+// Bounds the archives parsed but not merged yet
+const int MAX_PENDING_ARCHIVES = 8;
+// Merges write to the local and remote dirs, more of them would only
+// compete for the same disks
+const int MERGE_THREAD_COUNT = 2;
+
+struct ArchiveParser {
+    typedef SolutionArchive result_type;
+
+    SolutionArchive operator()(const QString& path) const
+    {
+        pendingArchives->acquire();
+        SolutionArchive archive;
+        if (!isCancelRequested->load())
+            archive = openSolutionArchive(path);
+        // Only archives that go on to the merge keep their place
+        if (!archive.reader)
+            pendingArchives->release();
+        return archive;
+    }
+
+    QSemaphore* pendingArchives;
+    const QAtomicInt* isCancelRequested;
+};
+
+class MergeTask : public QRunnable
+{
+public:
+    MergeTask(QObject* importer, int index, const SolutionArchive& archive,
+              QSemaphore* pendingArchives, const QAtomicInt* isCancelRequested)
+        : importer(importer)
+        , index(index)
+        , archive(archive)
+        , pendingArchives(pendingArchives)
+        , isCancelRequested(isCancelRequested)
+    {}
+
+    void run() override
+    {
+        bool isSkipped = isCancelRequested->load();
+        bool isMerged = !isSkipped && mergeSolutionArchive(archive);
+        archive = SolutionArchive();
+        pendingArchives->release();
+        QMetaObject::invokeMethod(importer, "onArchiveMerged", Qt::QueuedConnection,
+                                  Q_ARG(int, index), Q_ARG(bool, isMerged),
+                                  Q_ARG(bool, isSkipped));
+    }
+
+private:
+    QObject* importer;
+    int index;
+    SolutionArchive archive;
+    QSemaphore* pendingArchives;
+    const QAtomicInt* isCancelRequested;
+};
+} // namespace
+
+SolutionImporter::SolutionImporter(QObject *parent)
+    : QObject(parent)
+    , watcher(new QFutureWatcher<SolutionArchive>(this))
+    , mergePool(new QThreadPool(this))
+    , pendingArchives(MAX_PENDING_ARCHIVES)
+    , isCancelRequested(0)
+    , mergingCount(0)
+    , doneCount(0)
+    , importedCount(0)
+{
+    mergePool->setMaxThreadCount(MERGE_THREAD_COUNT);
+    connect(watcher, SIGNAL(resultReadyAt(int)), this, SLOT(onArchiveParsed(int)));
+    connect(watcher, SIGNAL(finished()), this, SLOT(onParsingFinished()));
+}
+
+SolutionImporter::~SolutionImporter()
+{
+    cancel();
+    // Parsers waiting for a place are let through to see the cancel
+    pendingArchives.release(MAX_PENDING_ARCHIVES);
+    watcher->waitForFinished();
+    mergePool->waitForDone();
+}
+
+void SolutionImporter::start(const QStringList& archivePaths)
+{
+    if (isRunning())
+        return;
+    paths = archivePaths;
+    isCancelRequested.store(0);
+    mergingCount = 0;
+    doneCount = 0;
+    importedCount = 0;
+    failedPathList.clear();
+    beginSolutionsImport();
+    watcher->setFuture(QtConcurrent::mapped(
+                           paths, ArchiveParser{ &pendingArchives, &isCancelRequested }));
+}
+
+void SolutionImporter::cancel()
+{
+    // Archives that are already being merged are finished
+    isCancelRequested.store(1);
+    watcher->cancel();
+}
+
+bool SolutionImporter::isRunning() const
+{
+    return watcher->isRunning() || mergingCount > 0;
+}
+
+int SolutionImporter::totalNum() const
+{
+    return paths.size();
+}
+
+int SolutionImporter::importedNum() const
+{
+    return importedCount;
+}
+
+const QStringList& SolutionImporter::failedPaths() const
+{
+    return failedPathList;
+}
+
+bool SolutionImporter::isCanceled() const
+{
+    return isCancelRequested.load();
+}
+
+void SolutionImporter::onArchiveParsed(int index)
+{
+    auto archive = watcher->resultAt(index);
+    if (!archive.reader) {
+        // Archives skipped after a cancel are not reported
+        if (!isCancelRequested.load())
+            reportDone(index, false);
+        return;
+    }
+    mergingCount++;
+    mergePool->start(new MergeTask(this, index, archive, &pendingArchives, &isCancelRequested));
+}
+
+void SolutionImporter::onArchiveMerged(int index, bool isMerged, bool isSkipped)
+{
+    mergingCount--;
+    if (!isSkipped)
+        reportDone(index, isMerged);
+    finishIfDone();
+}
+
+void SolutionImporter::onParsingFinished()
+{
+    finishIfDone();
+}
+
+void SolutionImporter::reportDone(int index, bool isImported)
+{
+    doneCount++;
+    if (isImported)
+        importedCount++;
+    else
+        failedPathList.append(paths[index]);
+    emit archiveImported(paths[index], doneCount, paths.size());
+}
+
+void SolutionImporter::finishIfDone()
+{
+    if (isRunning())
+        return;
+    endSolutionsImport();
+    emit finished();
+}
@@ -0,0 +1,61 @@
+#ifndef SOLUTIONIMPORTER_H
+#define SOLUTIONIMPORTER_H
+
+#include "solution_utils.h"
+
+#include <QObject>
+#include <QAtomicInt>
+#include <QSemaphore>
+#include <QStringList>
+
+template <typename T> class QFutureWatcher;
+class QThreadPool;
+
+// Imports many solution archives in the background. Archives are opened
+// and parsed on the global thread pool and handed to a small pool of
+// their own for merging, so the stages of different archives overlap.
+class SolutionImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SolutionImporter(QObject *parent = 0);
+    ~SolutionImporter();
+
+    void start(const QStringList& archivePaths);
+    bool isRunning() const;
+
+    int totalNum() const;
+    int importedNum() const;
+    const QStringList& failedPaths() const;
+    bool isCanceled() const;
+
+public slots:
+    void cancel();
+
+signals:
+    void archiveImported(QString path, int doneNum, int totalNum);
+    void finished();
+
+private slots:
+    void onArchiveParsed(int index);
+    void onArchiveMerged(int index, bool isMerged, bool isSkipped);
+    void onParsingFinished();
+
+private:
+    void reportDone(int index, bool isImported);
+    void finishIfDone();
+
+    QFutureWatcher<SolutionArchive>* watcher;
+    QThreadPool* mergePool;
+    // Parsed archives keep their files mapped until they are merged
+    QSemaphore pendingArchives;
+    QAtomicInt isCancelRequested;
+    QStringList paths;
+    int mergingCount;
+    int doneCount;
+    int importedCount;
+    QStringList failedPathList;
+};
+
+#endif // SOLUTIONIMPORTER_H
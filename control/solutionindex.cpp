@@ -0,0 +1,154 @@
+#include "solutionindex.h"
+#include "group_utils.h"
+#include <QtAlgorithms>
+
+namespace {
+const int WORD_BITS = 64;
+
+int wordsNum(int rowsNum)
+{
+    return (rowsNum + WORD_BITS - 1) / WORD_BITS;
+}
+
+void andWith(SolutionIndex::Bitmap& dst, const SolutionIndex::Bitmap& src)
+{
+    quint64* dstData = dst.data();
+    const quint64* srcData = src.constData();
+    for (int i = 0; i < dst.size(); ++i)
+        dstData[i] &= srcData[i];
+}
+
+void orWith(SolutionIndex::Bitmap& dst, const SolutionIndex::Bitmap& src)
+{
+    quint64* dstData = dst.data();
+    const quint64* srcData = src.constData();
+    for (int i = 0; i < dst.size(); ++i)
+        dstData[i] |= srcData[i];
+}
+
+void setBit(SolutionIndex::Bitmap& bitmap, int row)
+{
+    bitmap[row / WORD_BITS] |= Q_UINT64_C(1) << (row % WORD_BITS);
+}
+
+int addKey(QHash<QString, int>& ids, QString key)
+{
+    auto it = ids.constFind(key);
+    if (it != ids.cend())
+        return it.value();
+    int id = ids.size();
+    ids.insert(key, id);
+    return id;
+}
+}
+
+SolutionIndex::SolutionIndex()
+    : rowsCount(0)
+{}
+
+void SolutionIndex::build(const QStringList& sectionNames, const QStringList& userNames)
+{
+    rowsCount = sectionNames.size();
+    sectionIds.clear();
+    userIds.clear();
+    groupIds.clear();
+    sectionBitmaps.clear();
+    userBitmaps.clear();
+    groupBitmaps.clear();
+
+    for (int row = 0; row < rowsCount; ++row) {
+        int sectionId = addKey(sectionIds, sectionNames[row]);
+        if (sectionId == sectionBitmaps.size())
+            sectionBitmaps.append(makeBitmap(false));
+        setBit(sectionBitmaps[sectionId], row);
+
+        int userId = addKey(userIds, userNames[row]);
+        if (userId == userBitmaps.size())
+            userBitmaps.append(makeBitmap(false));
+        setBit(userBitmaps[userId], row);
+    }
+
+    // Membership is resolved once per user, not once per row
+    Bitmap groupedBitmap = makeBitmap(false);
+    foreach (const auto& group, getGroups()) {
+        Bitmap bitmap = makeBitmap(false);
+        foreach (const auto& userName, group.userNames) {
+            auto it = userIds.constFind(userName);
+            if (it != userIds.cend())
+                orWith(bitmap, userBitmaps[it.value()]);
+        }
+        orWith(groupedBitmap, bitmap);
+        groupIds.insert(group.id, groupBitmaps.size());
+        groupBitmaps.append(bitmap);
+    }
+    noGroupBitmap = makeBitmap(true);
+    for (int i = 0; i < noGroupBitmap.size(); ++i)
+        noGroupBitmap[i] &= ~groupedBitmap[i];
+}
+
+SolutionIndex::Bitmap SolutionIndex::select(QString sectionName, QString userName,
+                                            GroupFilter groupFilter,
+                                            const QUuid& groupId) const
+{
+    Bitmap result = makeBitmap(true);
+    if (!sectionName.isEmpty()) {
+        auto it = sectionIds.constFind(sectionName);
+        if (it == sectionIds.cend())
+            return makeBitmap(false);
+        andWith(result, sectionBitmaps[it.value()]);
+    }
+    if (!userName.isEmpty()) {
+        auto it = userIds.constFind(userName);
+        if (it == userIds.cend())
+            return makeBitmap(false);
+        andWith(result, userBitmaps[it.value()]);
+        return result;
+    }
+    switch (groupFilter) {
+    case GroupFilter::Any:
+        break;
+    case GroupFilter::NoGroup:
+        andWith(result, noGroupBitmap);
+        break;
+    case GroupFilter::Group: {
+        auto it = groupIds.constFind(groupId);
+        if (it == groupIds.cend())
+            return makeBitmap(false);
+        andWith(result, groupBitmaps[it.value()]);
+        break;
+    }
+    }
+    return result;
+}
+
+int SolutionIndex::rowsNum() const
+{
+    return rowsCount;
+}
+
+bool SolutionIndex::contains(const Bitmap& bitmap, int row)
+{
+    int word = row / WORD_BITS;
+    if (row < 0 || word >= bitmap.size())
+        return false;
+    return (bitmap[word] >> (row % WORD_BITS)) & 1;
+}
+
+int SolutionIndex::count(const Bitmap& bitmap)
+{
+    // qPopulationCount() compiles to the POPCNT instruction where available
+    int result = 0;
+    foreach (quint64 word, bitmap)
+        result += qPopulationCount(word);
+    return result;
+}
+
+SolutionIndex::Bitmap SolutionIndex::makeBitmap(bool isFull) const
+{
+    Bitmap bitmap(wordsNum(rowsCount), isFull ? ~Q_UINT64_C(0) : 0);
+    // Bits past the last row are never set, so counts stay exact
+    int tailBits = rowsCount % WORD_BITS;
+    if (isFull && tailBits != 0)
+        bitmap.last() = (Q_UINT64_C(1) << tailBits) - 1;
+    return bitmap;
+}
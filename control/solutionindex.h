@@ -0,0 +1,52 @@
+#ifndef SOLUTIONINDEX_H
+#define SOLUTIONINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QString>
+#include <QUuid>
+#include <QVector>
+
+// Bitmaps of the rows of SolutionsModel for every section, user and group,
+// so that a filter is a few ANDs of whole words instead of a pass over the
+// solutions with string comparisons and group lookups. Sections, users and
+// groups get dense ids when the index is built.
+class SolutionIndex
+{
+public:
+    typedef QVector<quint64> Bitmap;
+
+    enum class GroupFilter {
+        Any,
+        NoGroup,
+        Group
+    };
+
+    SolutionIndex();
+
+    // Both lists are indexed by row
+    void build(const QStringList& sectionNames, const QStringList& userNames);
+    // Empty names and GroupFilter::Any disable the corresponding filter.
+    // The group is ignored when the user is set, as the user is more
+    // specific.
+    Bitmap select(QString sectionName, QString userName,
+                  GroupFilter groupFilter, const QUuid& groupId) const;
+    int rowsNum() const;
+
+    static bool contains(const Bitmap& bitmap, int row);
+    static int count(const Bitmap& bitmap);
+
+private:
+    Bitmap makeBitmap(bool isFull) const;
+
+    int rowsCount;
+    QHash<QString, int> sectionIds;
+    QHash<QString, int> userIds;
+    QHash<QUuid, int> groupIds;
+    QVector<Bitmap> sectionBitmaps;
+    QVector<Bitmap> userBitmaps;
+    QVector<Bitmap> groupBitmaps;
+    Bitmap noGroupBitmap;
+};
+
+#endif // SOLUTIONINDEX_H
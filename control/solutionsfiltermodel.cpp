@@ -0,0 +1,43 @@
+#include "solutionsfiltermodel.h"
+#include "solutionsmodel.h"
+
+SolutionsFilterModel::SolutionsFilterModel(SolutionsModel* solutionsModel, QObject* parent)
+    : QSortFilterProxyModel(parent)
+    , solutionsModel(solutionsModel)
+    , groupFilter(SolutionIndex::GroupFilter::Any)
+{
+    // Connected before setSourceModel(), so the rows are selected before
+    // the proxy refilters the reset model
+    connect(solutionsModel, SIGNAL(modelReset()), this, SLOT(selectRows()));
+    setSourceModel(solutionsModel);
+    setSortRole(SolutionsModel::SortRole);
+    selectRows();
+}
+
+void SolutionsFilterModel::setFilter(QString sectionName, QString userName,
+                                     SolutionIndex::GroupFilter groupFilter,
+                                     const QUuid& groupId)
+{
+    this->sectionName = sectionName;
+    this->userName = userName;
+    this->groupFilter = groupFilter;
+    this->groupId = groupId;
+    selectRows();
+    invalidateFilter();
+}
+
+int SolutionsFilterModel::acceptedNum() const
+{
+    return SolutionIndex::count(acceptedRows);
+}
+
+bool SolutionsFilterModel::filterAcceptsRow(int sourceRow, const QModelIndex&) const
+{
+    return SolutionIndex::contains(acceptedRows, sourceRow);
+}
+
+void SolutionsFilterModel::selectRows()
+{
+    acceptedRows = solutionsModel->solutionIndex().select(
+                sectionName, userName, groupFilter, groupId);
+}
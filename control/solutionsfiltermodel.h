@@ -0,0 +1,41 @@
+#ifndef SOLUTIONSFILTERMODEL_H
+#define SOLUTIONSFILTERMODEL_H
+
+#include "solutionindex.h"
+#include <QSortFilterProxyModel>
+#include <QString>
+#include <QUuid>
+
+class SolutionsModel;
+
+// Filters the rows of SolutionsModel by section, user and group. The rows
+// to show are selected once per filter change with the index of the model,
+// so checking a row is a single bit test.
+class SolutionsFilterModel : public QSortFilterProxyModel
+{
+    Q_OBJECT
+
+public:
+    explicit SolutionsFilterModel(SolutionsModel* solutionsModel, QObject* parent = 0);
+
+    // See SolutionIndex::select()
+    void setFilter(QString sectionName, QString userName,
+                   SolutionIndex::GroupFilter groupFilter, const QUuid& groupId);
+    int acceptedNum() const;
+
+protected:
+    bool filterAcceptsRow(int sourceRow, const QModelIndex& sourceParent) const override;
+
+private slots:
+    void selectRows();
+
+private:
+    SolutionsModel* solutionsModel;
+    QString sectionName;
+    QString userName;
+    SolutionIndex::GroupFilter groupFilter;
+    QUuid groupId;
+    SolutionIndex::Bitmap acceptedRows;
+};
+
+#endif // SOLUTIONSFILTERMODEL_H
@@ -2,20 +2,14 @@
 #include "solution_utils.h"
 #include "section_utils.h"
 #include "group_utils.h"
+#include "settings.h"
+#include "solutionwatcher.h"
+#include "solutionsmodel.h"
+#include "solutionsfiltermodel.h"
 #include "ui_solutionsform.h"
 #include <QMessageBox>
 
 namespace {
-QString makeStatistics(const Section& section, const Solution& solution)
-{
-    int casesNum = section.cases.size();
-    int answersNum = solution.finalAnswersNum();
-    int percent = casesNum > answersNum
-            ? static_cast<int>(100.0f * answersNum / casesNum + 0.5f)
-            : 100;
-    return QString("%1 из %2 (%3\%)").arg(answersNum).arg(casesNum).arg(percent);
-}
-
 const QString NO_FILTER_TEXT = "* Не фильтровать *";
 const int NO_FILTER_INDEX = 0;
 const QString NO_GROUP_TEXT = "* Только без группы *";
@@ -24,20 +18,25 @@ const int NO_GROUP_INDEX = 1;
 
 SolutionsForm::SolutionsForm(QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::SolutionsForm)
+    ui(new Ui::SolutionsForm),
+    solutionWatcher(new SolutionWatcher(this)),
+    solutionsModel(new SolutionsModel(this)),
+    filterModel(new SolutionsFilterModel(solutionsModel, this))
 {
     ui->setupUi(this);
 
-    ui->tableWidget->setColumnWidth(0, 100);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
-    ui->tableWidget->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
-    ui->tableWidget->setColumnWidth(4, 100);
+    ui->tableView->setModel(filterModel);
+    ui->tableView->setColumnWidth(0, 100);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(1, QHeaderView::Stretch);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(2, QHeaderView::Stretch);
+    ui->tableView->horizontalHeader()->setSectionResizeMode(3, QHeaderView::Stretch);
+    ui->tableView->setColumnWidth(4, 100);
 
     connect(ui->updateButton, SIGNAL(clicked()), this, SLOT(reload()));
     connect(ui->applyFilterButton, SIGNAL(clicked()), this, SLOT(applyFilter()));
-    connect(ui->tableWidget->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
+    connect(ui->tableView->selectionModel(), SIGNAL(selectionChanged(QItemSelection,QItemSelection)),
             this, SLOT(onSelectionChanged(QItemSelection,QItemSelection)));
+    connect(solutionWatcher, SIGNAL(solutionsChanged()), this, SLOT(onSolutionsChanged()));
 }
 
 SolutionsForm::~SolutionsForm()
@@ -45,12 +44,15 @@ SolutionsForm::~SolutionsForm()
     delete ui;
 }
 
-void SolutionsForm::reload()
+void SolutionsForm::reload(bool forceRebuild)
 {
-    while (ui->tableWidget->rowCount() > 0)
-        ui->tableWidget->removeRow(ui->tableWidget->rowCount() - 1);
-    loadSections();
+    loadSections(forceRebuild);
+    ui->updateButton->setToolTip(QString("Разделов из кэша: %1, прочитано заново: %2")
+                                 .arg(getCachedSectionsNum())
+                                 .arg(getParsedSectionsNum()));
     loadSolutions();
+    updateModel();
+    solutionWatcher->watch(Settings::instance().solutionsPath);
 
     updateComboBox(ui->sectionNameComboBox, getSectionNames());
     if (ui->groupNameComboBox->count() == 0)
@@ -59,8 +61,16 @@ void SolutionsForm::reload()
     applyFilter();
 }
 
+void SolutionsForm::onSolutionsChanged()
+{
+    updateModel();
+    selectGroupComboVariant(ui->groupNameComboBox->currentIndex());
+    applyFilter();
+}
+
 void SolutionsForm::onGroupCollectionChanged()
 {
+    updateModel();
     updateGroupComboBox();
     selectGroupComboVariant(ui->groupNameComboBox->currentIndex());
     applyFilter();
@@ -73,42 +83,28 @@ void SolutionsForm::onGroupAdded(const QUuid&)
 
 void SolutionsForm::applyFilter()
 {
-    const auto& allSolutions = getSolutions();
     int sectionIndex = ui->sectionNameComboBox->currentIndex();
     int userIndex = ui->userNameComboBox->currentIndex();
     int groupIndex = ui->groupNameComboBox->currentIndex();
-    if (sectionIndex == NO_FILTER_INDEX
-        && userIndex == NO_FILTER_INDEX
-        && groupIndex == NO_FILTER_INDEX)
-        fillTable(allSolutions);
-
-    const auto& sections = getSections();
-    QString sectionName = ui->sectionNameComboBox->currentText();
-    QString userName = ui->userNameComboBox->currentText();
-    const auto& group = getGroup(ui->groupNameComboBox->currentData().toUuid());
-    QList<Solution> filteredSolutions;
-    filteredSolutions.reserve(allSolutions.size());
-    foreach (const auto& solution, allSolutions) {
-        if (sectionIndex != NO_FILTER_INDEX
-            && sectionName != sections[solution.sectionId].name)
-            continue;
-        if (userIndex == NO_FILTER_INDEX) {
-            if (groupIndex != NO_FILTER_INDEX) {
-                if (groupIndex == NO_GROUP_INDEX) {
-                    if (!getGroupsByUserName(solution.userName).empty())
-                        continue;
-                } else {
-                    if (!group.userNames.contains(solution.userName))
-                        continue;
-                }
-            }
-        } else {
-            if (userName != solution.userName)
-                continue;
-        }
-        filteredSolutions.append(solution);
+    QString sectionName = sectionIndex != NO_FILTER_INDEX
+            ? ui->sectionNameComboBox->currentText()
+            : QString();
+    QString userName = userIndex != NO_FILTER_INDEX
+            ? ui->userNameComboBox->currentText()
+            : QString();
+    auto groupFilter = SolutionIndex::GroupFilter::Any;
+    QUuid groupId;
+    if (groupIndex == NO_GROUP_INDEX) {
+        groupFilter = SolutionIndex::GroupFilter::NoGroup;
+    } else if (groupIndex > NO_GROUP_INDEX) {
+        groupFilter = SolutionIndex::GroupFilter::Group;
+        groupId = ui->groupNameComboBox->currentData().toUuid();
     }
-    fillTable(filteredSolutions);
+    ui->tableView->selectionModel()->clearSelection();
+    filterModel->setFilter(sectionName, userName, groupFilter, groupId);
+    ui->countLabel->setText(QString("Найдено: %1 из %2")
+                            .arg(filterModel->acceptedNum())
+                            .arg(solutionsModel->rowCount()));
 }
 
 void SolutionsForm::onSelectionChanged(const QItemSelection&, const QItemSelection&)
@@ -126,81 +122,47 @@ void SolutionsForm::on_resetFilterButton_clicked()
 
 void SolutionsForm::on_selectSectionButton_clicked()
 {
-    int row = ui->tableWidget->selectionModel()->selectedRows()[0].row();
-    ui->sectionNameComboBox->setCurrentText(ui->tableWidget->item(row, 1)->text());
+    int row = selectedRow();
+    if (row < 0)
+        return;
+    ui->sectionNameComboBox->setCurrentText(solutionsModel->row(row).sectionName);
     applyFilter();
 }
 
 void SolutionsForm::on_selectUserButton_clicked()
 {
-    int row = ui->tableWidget->selectionModel()->selectedRows()[0].row();
-    ui->userNameComboBox->setCurrentText(ui->tableWidget->item(row, 2)->text());
+    int row = selectedRow();
+    if (row < 0)
+        return;
+    ui->userNameComboBox->setCurrentText(solutionsModel->row(row).userName);
     applyFilter();
 }
 
 void SolutionsForm::on_openButton_clicked()
 {
-    int row = ui->tableWidget->selectionModel()->selectedRows()[0].row();
-    openSolutionInRow(row);
+    int row = selectedRow();
+    if (row >= 0)
+        openSolutionInRow(row);
 }
 
-void SolutionsForm::on_tableWidget_doubleClicked(const QModelIndex &index)
+void SolutionsForm::on_tableView_doubleClicked(const QModelIndex &index)
 {
-    openSolutionInRow(index.row());
+    openSolutionInRow(filterModel->mapToSource(index).row());
 }
 
-void SolutionsForm::fillTable(const QList<Solution>& solutions)
+void SolutionsForm::updateModel()
 {
-    ui->tableWidget->selectionModel()->clearSelection();
-    const auto& sections = getSections();
-    ui->tableWidget->setRowCount(solutions.size());
-
-    ui->tableWidget->setSortingEnabled(false);
-    for (int i = 0; i < solutions.size(); ++i) {
-        const auto& solution = solutions[i];
-        const auto& section = sections[solution.sectionId];
-
-        QTableWidgetItem* statusItem = new QTableWidgetItem();
-        if (solution.finalAnswersNum() == section.cases.size()) {
-            statusItem->setIcon(QIcon(":/icons/answered.png"));
-            statusItem->setText("Завершен");
-        } else {
-            statusItem->setIcon(QIcon(":/icons/in_progress.png"));
-            statusItem->setText("В процессе");
-        }
-        ui->tableWidget->setItem(i, 0, statusItem);
-
-        QTableWidgetItem* sectionNameItem = new QTableWidgetItem();
-        sectionNameItem->setText(section.name);
-        sectionNameItem->setData(Qt::UserRole, section.id);
-        ui->tableWidget->setItem(i, 1, sectionNameItem);
-
-        QTableWidgetItem* userNameItem = new QTableWidgetItem();
-        userNameItem->setText(solution.userName);
-        ui->tableWidget->setItem(i, 2, userNameItem);
-
-        QTableWidgetItem* groupNameItem = new QTableWidgetItem();
-        const auto& groups = getGroupsByUserName(solution.userName);
-        QUuid groupId;
-        if (groups.size() == 1) {
-            groupId = groups.first()->id;
-            groupNameItem->setText(groups.first()->name);
-        } else if (groups.size() > 1) {
-            QStringList groupNames;
-            groupNames.reserve(groups.size());
-            for (const auto& group : groups)
-                groupNames.append(group->name);
-            groupNameItem->setText(groupNames.join(", "));
-        }
-        groupNameItem->setData(Qt::UserRole, groupId);
-        ui->tableWidget->setItem(i, 3, groupNameItem);
+    ui->tableView->selectionModel()->clearSelection();
+    solutionsModel->setSolutions(getSolutions());
+}
 
-        QTableWidgetItem* statisticsItem = new QTableWidgetItem();
-        statisticsItem->setText(makeStatistics(section, solution));
-        statisticsItem->setTextAlignment(Qt::AlignHCenter | Qt::AlignVCenter);
-        ui->tableWidget->setItem(i, 4, statisticsItem);
-    }
-    ui->tableWidget->setSortingEnabled(true);
+// Returns the row of the source model or -1
+int SolutionsForm::selectedRow() const
+{
+    const auto& rows = ui->tableView->selectionModel()->selectedRows();
+    if (rows.size() != 1)
+        return -1;
+    return filterModel->mapToSource(rows[0]).row();
 }
 
 void SolutionsForm::updateComboBox(QComboBox* comboBox, const QStringList& variants)
@@ -271,20 +233,20 @@ void SolutionsForm::selectGroupComboVariant(int index)
 
 void SolutionsForm::updateButtons()
 {
-    const auto& rows = ui->tableWidget->selectionModel()->selectedRows();
-    bool isRowSelected = rows.size() == 1;
+    int row = selectedRow();
+    bool isRowSelected = row >= 0;
     ui->selectSectionButton->setEnabled(isRowSelected);
     ui->selectUserButton->setEnabled(isRowSelected);
     ui->selectGroupButton->setEnabled(
-                isRowSelected
-                && !ui->tableWidget->item(rows[0].row(), 3)->data(Qt::UserRole).isNull());
+                isRowSelected && !solutionsModel->row(row).groupId.isNull());
     ui->openButton->setEnabled(isRowSelected);
 }
 
 void SolutionsForm::openSolutionInRow(int row)
 {
-    auto userName = ui->tableWidget->item(row, 2)->text();
-    auto sectionId = ui->tableWidget->item(row, 1)->data(Qt::UserRole).toUuid();
+    const auto& modelRow = solutionsModel->row(row);
+    auto userName = modelRow.userName;
+    auto sectionId = modelRow.sectionId;
     const auto& solution = getSolution(userName, sectionId);
     if (!solution.isValid()) {
         QMessageBox::warning(this, "Ошибка при открытии",
@@ -296,11 +258,12 @@ void SolutionsForm::openSolutionInRow(int row)
 
 void SolutionsForm::on_selectGroupButton_clicked()
 {
-    int row = ui->tableWidget->selectionModel()->selectedRows()[0].row();
-    auto idVariant = ui->tableWidget->item(row, 3)->data(Qt::UserRole);
-    if (idVariant.isNull())
+    int row = selectedRow();
+    if (row < 0)
+        return;
+    auto id = solutionsModel->row(row).groupId;
+    if (id.isNull())
         return;
-    auto id = idVariant.toUuid();
     for (int i = 2; i < ui->groupNameComboBox->count(); ++i) {
         if (ui->groupNameComboBox->itemData(i).toUuid() == id) {
             ui->groupNameComboBox->setCurrentIndex(i);
@@ -10,6 +10,9 @@ class SolutionsForm;
 class QComboBox;
 class Solution;
 class QItemSelection;
+class SolutionWatcher;
+class SolutionsModel;
+class SolutionsFilterModel;
 
 class SolutionsForm : public QWidget
 {
@@ -23,23 +26,25 @@ signals:
     void requestedOpen(const Solution& solution);
 
 public slots:
-    void reload();
+    void reload(bool forceRebuild = false);
     void onGroupCollectionChanged();
     void onGroupAdded(const QUuid&);
 
 private slots:
     void applyFilter();
+    void onSolutionsChanged();
     void onSelectionChanged(const QItemSelection &, const QItemSelection &);
     void on_resetFilterButton_clicked();
     void on_selectSectionButton_clicked();
     void on_selectUserButton_clicked();
     void on_openButton_clicked();
-    void on_tableWidget_doubleClicked(const QModelIndex &index);
+    void on_tableView_doubleClicked(const QModelIndex &index);
     void on_selectGroupButton_clicked();
     void on_groupNameComboBox_currentIndexChanged(int index);
 
 private:
-    void fillTable(const QList<Solution>& solutions);
+    void updateModel();
+    int selectedRow() const;
     void updateComboBox(QComboBox* comboBox, const QStringList& variants);
     void updateGroupComboBox();
     void selectGroupComboVariant(int index);
@@ -47,6 +52,9 @@ private:
     void openSolutionInRow(int row);
 
     Ui::SolutionsForm *ui;
+    SolutionWatcher* solutionWatcher;
+    SolutionsModel* solutionsModel;
+    SolutionsFilterModel* filterModel;
     bool isGroupComboBoxReady = true;
 };
 
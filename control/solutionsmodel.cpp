@@ -0,0 +1,134 @@
+#include "solutionsmodel.h"
+#include "section_utils.h"
+#include "group_utils.h"
+#include "solution_utils.h"
+#include <omkit/solution.h>
+#include <QStringList>
+
+namespace {
+const QString COMPLETED_TEXT = "Завершен";
+const QString IN_PROGRESS_TEXT = "В процессе";
+
+const QStringList HEADERS = QStringList()
+        << "Статус" << "Раздел" << "Имя пользователя" << "Группа" << "Отвечено";
+
+void setGroups(SolutionsModel::Row& row)
+{
+    const auto& groups = getGroupsByUserName(row.userName);
+    row.hasGroup = !groups.isEmpty();
+    if (groups.size() == 1) {
+        row.groupId = groups.first()->id;
+        row.groupNames = groups.first()->name;
+    } else if (groups.size() > 1) {
+        QStringList groupNames;
+        groupNames.reserve(groups.size());
+        for (const auto& group : groups)
+            groupNames.append(group->name);
+        row.groupNames = groupNames.join(", ");
+    }
+}
+}
+
+SolutionsModel::SolutionsModel(QObject* parent)
+    : QAbstractTableModel(parent)
+    , answeredIcon(":/icons/answered.png")
+    , inProgressIcon(":/icons/in_progress.png")
+{}
+
+void SolutionsModel::setSolutions(const QList<Solution>& solutions)
+{
+    const auto& sections = getSections();
+    beginResetModel();
+    rows.clear();
+    rows.reserve(solutions.size());
+    QStringList sectionNames;
+    QStringList userNames;
+    sectionNames.reserve(solutions.size());
+    userNames.reserve(solutions.size());
+    foreach (const auto& solution, solutions) {
+        const auto& section = sections[solution.sectionId];
+        Row row;
+        row.sectionId = section.id;
+        row.sectionName = section.name;
+        row.userName = solution.userName;
+        setGroups(row);
+        row.stats = getCompletionStats(solution);
+        row.statistics = QString("%1 из %2 (%3\%)")
+                .arg(row.stats.finalAnswersNum).arg(row.stats.casesNum).arg(row.stats.percent);
+        rows.append(row);
+        sectionNames.append(row.sectionName);
+        userNames.append(row.userName);
+    }
+    filterIndex.build(sectionNames, userNames);
+    endResetModel();
+}
+
+const SolutionsModel::Row& SolutionsModel::row(int index) const
+{
+    return rows[index];
+}
+
+const SolutionIndex& SolutionsModel::solutionIndex() const
+{
+    return filterIndex;
+}
+
+int SolutionsModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : rows.size();
+}
+
+int SolutionsModel::columnCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : ColumnsNum;
+}
+
+QVariant SolutionsModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= rows.size())
+        return QVariant();
+
+    const auto& row = rows[index.row()];
+    bool isCompleted = row.stats.isCompleted;
+    switch (role) {
+    case Qt::DisplayRole:
+        switch (index.column()) {
+        case StatusColumn: return isCompleted ? COMPLETED_TEXT : IN_PROGRESS_TEXT;
+        case SectionColumn: return row.sectionName;
+        case UserColumn: return row.userName;
+        case GroupColumn: return row.groupNames;
+        case StatisticsColumn: return row.statistics;
+        }
+        break;
+    case SortRole:
+        switch (index.column()) {
+        case StatusColumn: return isCompleted;
+        case StatisticsColumn:
+            // Ties in percent are broken by the number of answers
+            return static_cast<qlonglong>(row.stats.percent) * 100000
+                    + row.stats.finalAnswersNum;
+        default: return data(index, Qt::DisplayRole);
+        }
+    case Qt::DecorationRole:
+        if (index.column() == StatusColumn)
+            return isCompleted ? answeredIcon : inProgressIcon;
+        break;
+    case Qt::TextAlignmentRole:
+        if (index.column() == StatisticsColumn)
+            return static_cast<int>(Qt::AlignHCenter | Qt::AlignVCenter);
+        break;
+    case SectionIdRole:
+        return row.sectionId;
+    case GroupIdRole:
+        return row.groupId.isNull() ? QVariant() : QVariant(row.groupId);
+    }
+    return QVariant();
+}
+
+QVariant SolutionsModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole
+        && section >= 0 && section < HEADERS.size())
+        return HEADERS[section];
+    return QAbstractTableModel::headerData(section, orientation, role);
+}
@@ -0,0 +1,69 @@
+#ifndef SOLUTIONSMODEL_H
+#define SOLUTIONSMODEL_H
+
+#include "solutionindex.h"
+#include <omkit/completionstats.h>
+#include <QAbstractTableModel>
+#include <QIcon>
+#include <QList>
+#include <QString>
+#include <QUuid>
+
+class Solution;
+
+// Table of all solutions shown in SolutionsForm. Everything the view needs
+// is computed once per reload, so filtering and sorting do not touch the
+// solutions or groups again.
+class SolutionsModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        StatusColumn,
+        SectionColumn,
+        UserColumn,
+        GroupColumn,
+        StatisticsColumn,
+        ColumnsNum
+    };
+
+    enum Role {
+        // Typed value to sort by, e.g. the percent of answered cases
+        SortRole = Qt::UserRole + 1,
+        SectionIdRole,
+        GroupIdRole
+    };
+
+    struct Row {
+        QUuid sectionId;
+        QString sectionName;
+        QString userName;
+        // Set only if the user is in exactly one group
+        QUuid groupId;
+        QString groupNames;
+        bool hasGroup;
+        CompletionStats stats;
+        QString statistics;
+    };
+
+    explicit SolutionsModel(QObject* parent = 0);
+
+    void setSolutions(const QList<Solution>& solutions);
+    const Row& row(int index) const;
+    const SolutionIndex& solutionIndex() const;
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation,
+                        int role = Qt::DisplayRole) const override;
+
+private:
+    QList<Row> rows;
+    SolutionIndex filterIndex;
+    QIcon answeredIcon;
+    QIcon inProgressIcon;
+};
+
+#endif // SOLUTIONSMODEL_H
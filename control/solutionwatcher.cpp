@@ -0,0 +1,183 @@
+#include "solutionwatcher.h"
+#include "solution_utils.h"
+#include <omkit/solution.h>
+#include <QDir>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QTimer>
+#include <QtConcurrent>
+
+namespace {
+// Notifications are collected for a short while, so that an answer file and
+// the solution file written right after it are re-read together.
+const int UPDATE_DELAY = 300;
+// Network shares often deliver no change notifications at all.
+const int SWEEP_INTERVAL = 15000;
+// Solution files live in <root>/<user name>/<solution dir>.
+const int SOLUTION_DIR_DEPTH = 2;
+// The rest of the solution dirs is only covered by the periodic sweep.
+const int MAX_WATCHED_PATHS = 4096;
+
+bool mergeChanged(const QStringList& paths)
+{
+    bool isChanged = false;
+    foreach (const auto& path, paths) {
+        if (mergeChangedSolutions(path))
+            isChanged = true;
+    }
+    return isChanged;
+}
+}
+
+SolutionWatcher::SolutionWatcher(QObject *parent)
+    : QObject(parent)
+    , watcher(new QFileSystemWatcher(this))
+    , updateTimer(new QTimer(this))
+    , sweepTimer(new QTimer(this))
+    , updateWatcher(new QFutureWatcher<bool>(this))
+    , isSweeping(false)
+{
+    updateTimer->setSingleShot(true);
+    updateTimer->setInterval(UPDATE_DELAY);
+    sweepTimer->setInterval(SWEEP_INTERVAL);
+
+    connect(watcher, SIGNAL(directoryChanged(QString)),
+            this, SLOT(onDirectoryChanged(QString)));
+    connect(watcher, SIGNAL(fileChanged(QString)),
+            this, SLOT(onFileChanged(QString)));
+    connect(updateTimer, SIGNAL(timeout()), this, SLOT(updateChangedPaths()));
+    connect(sweepTimer, SIGNAL(timeout()), this, SLOT(sweep()));
+    connect(updateWatcher, SIGNAL(finished()), this, SLOT(onUpdateFinished()));
+}
+
+SolutionWatcher::~SolutionWatcher()
+{
+    updateWatcher->waitForFinished();
+}
+
+void SolutionWatcher::watch(QString path)
+{
+    QString newRootPath = path.isEmpty() ? QString() : QDir(path).absolutePath();
+    if (newRootPath == rootPath && sweepTimer->isActive())
+        return;
+
+    QStringList watchedPaths = watcher->files() + watcher->directories();
+    if (!watchedPaths.isEmpty())
+        watcher->removePaths(watchedPaths);
+    changedPaths.clear();
+    updateTimer->stop();
+    sweepTimer->stop();
+
+    rootPath = newRootPath;
+    if (rootPath.isEmpty() || !QFileInfo(rootPath).isDir())
+        return;
+    addPaths(rootPath);
+    sweepTimer->start();
+}
+
+void SolutionWatcher::onDirectoryChanged(const QString& path)
+{
+    changedPaths.insert(path);
+    updateTimer->start();
+}
+
+void SolutionWatcher::onFileChanged(const QString& path)
+{
+    changedPaths.insert(QFileInfo(path).absolutePath());
+    updateTimer->start();
+}
+
+void SolutionWatcher::updateChangedPaths()
+{
+    // Paths changed during an update are taken when it finishes
+    if (updateWatcher->isRunning())
+        return;
+    auto paths = changedPaths;
+    changedPaths.clear();
+    if (paths.contains(rootPath)) {
+        paths.clear();
+        paths.insert(rootPath);
+    }
+
+    QStringList pathList;
+    foreach (const auto& path, paths) {
+        if (path == rootPath || path.startsWith(rootPath + "/"))
+            pathList.append(path);
+    }
+    if (!pathList.isEmpty())
+        startUpdate(pathList, false);
+}
+
+void SolutionWatcher::sweep()
+{
+    if (updateWatcher->isRunning())
+        return;
+    startUpdate(QStringList(rootPath), true);
+}
+
+void SolutionWatcher::onUpdateFinished()
+{
+    bool isChanged = updateWatcher->result();
+    if (isChanged)
+        updateSolutionLists();
+    foreach (const auto& path, updatedPaths) {
+        // The root may have changed while the update ran
+        if (path != rootPath && !path.startsWith(rootPath + "/"))
+            continue;
+        // Files replaced by renaming and newly created dirs are not watched yet
+        if ((isChanged || !isSweeping) && QFileInfo(path).isDir())
+            addPaths(path);
+    }
+    updatedPaths.clear();
+    if (isChanged)
+        emit solutionsChanged();
+    if (!changedPaths.isEmpty())
+        updateTimer->start();
+}
+
+void SolutionWatcher::startUpdate(const QStringList& paths, bool isSweep)
+{
+    updatedPaths = paths;
+    isSweeping = isSweep;
+    updateWatcher->setFuture(QtConcurrent::run(mergeChanged, paths));
+}
+
+void SolutionWatcher::addPaths(QString path)
+{
+    QString relativePath = QDir(rootPath).relativeFilePath(path);
+    int depth = relativePath == "." ? 0 : relativePath.count('/') + 1;
+    if (depth > SOLUTION_DIR_DEPTH)
+        return;
+
+    auto watchedPaths = (watcher->files() + watcher->directories()).toSet();
+    QStringList newPaths;
+    collectPaths(path, depth, watchedPaths, newPaths);
+    if (!newPaths.isEmpty())
+        watcher->addPaths(newPaths);
+}
+
+void SolutionWatcher::collectPaths(QString path, int depth,
+                                   const QSet<QString>& watchedPaths, QStringList& newPaths)
+{
+    bool isSolutionDir = depth == SOLUTION_DIR_DEPTH;
+    if (isSolutionDir && watchedPaths.size() + newPaths.size() >= MAX_WATCHED_PATHS)
+        return;
+    if (!watchedPaths.contains(path))
+        newPaths.append(path);
+
+    QDir dir(path);
+    if (!isSolutionDir) {
+        foreach (const auto& entry, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
+            collectPaths(dir.absoluteFilePath(entry), depth + 1, watchedPaths, newPaths);
+        return;
+    }
+
+    // Directory notifications do not report modified files on every platform
+    QStringList nameFilters;
+    nameFilters << "*.omsol" << "*.omsol" + Solution::JOURNAL_SUFFIX;
+    foreach (const auto& entry, dir.entryList(nameFilters, QDir::Files)) {
+        QString filePath = dir.absoluteFilePath(entry);
+        if (!watchedPaths.contains(filePath))
+            newPaths.append(filePath);
+    }
+}
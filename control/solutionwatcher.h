@@ -0,0 +1,50 @@
+#ifndef SOLUTIONWATCHER_H
+#define SOLUTIONWATCHER_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+class QFileSystemWatcher;
+class QTimer;
+
+class SolutionWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit SolutionWatcher(QObject *parent = 0);
+    ~SolutionWatcher();
+
+    void watch(QString path);
+
+signals:
+    void solutionsChanged();
+
+private slots:
+    void onDirectoryChanged(const QString& path);
+    void onFileChanged(const QString& path);
+    void updateChangedPaths();
+    void sweep();
+    void onUpdateFinished();
+
+private:
+    void startUpdate(const QStringList& paths, bool isSweep);
+    void addPaths(QString path);
+    void collectPaths(QString path, int depth, const QSet<QString>& watchedPaths,
+                      QStringList& newPaths);
+
+    QFileSystemWatcher* watcher;
+    QTimer* updateTimer;
+    QTimer* sweepTimer;
+    // Solutions are re-read on the thread pool, one update at a time
+    QFutureWatcher<bool>* updateWatcher;
+    QString rootPath;
+    QSet<QString> changedPaths;
+    QStringList updatedPaths;
+    bool isSweeping;
+};
+
+#endif // SOLUTIONWATCHER_H
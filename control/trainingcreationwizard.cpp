@@ -11,7 +11,7 @@
 #include <QFileDialog>
 #include <QDir>
 #include <QFileInfo>
-#include <QTemporaryDir>
+#include <QJsonDocument>
 
 namespace {
 const QString TRAINING_SRC_DIR = "bin/training_files";
@@ -173,22 +173,11 @@ void TrainingCreationWizard::on_nextButton_clicked()
         if (ui->archiveOption->isChecked()) {
             QString path = ui->pathEdit->text();
             Settings::instance().updateLastPath(QFileInfo(path).absolutePath());
-            QTemporaryDir tempDir;
-            if (!tempDir.isValid()) {
-                QMessageBox::warning(this, "Ошибка при сохранении",
-                                     "Невозможно создать временную папку для формирования тренажера.");
-                return;
-            }
-            if (saveDirectory(tempDir.path())) {
-                if (compress(tempDir.path(), path)) {
-                    showInExplorer(path);
-                    accept();
-                    return;
-                }
-                QMessageBox::warning(this, "Ошибка при сохранении",
-                                     "Не удалось создать архив с тренажером.");
-                return;
+            if (saveArchive(path)) {
+                showInExplorer(path);
+                accept();
             }
+            return;
         }
 
         if (ui->folderOption->isChecked()) {
@@ -276,39 +265,22 @@ bool TrainingCreationWizard::saveDirectory(QString path)
         return false;
     }
 
-    const auto& settings = Settings::instance();
-    TrainingSettings trainingSettings(dstDir.absoluteFilePath("Settings.json"));
-    bool saveGroupsToPackage = true;
-    if (ui->networkOption->isChecked()) {
-        trainingSettings.solutionsPath = settings.solutionsPath;
-        trainingSettings.sectionsPath = settings.sectionsPath;
-        if (!settings.groupsPath.isEmpty()) {
-            saveGroupsToPackage = false;
-            trainingSettings.groupsPath = settings.groupsPath;
-        }
-    } else {
-        trainingSettings.solutionsPath = "";
-        trainingSettings.sectionsPath = "sections";
-
+    auto trainingSettings = makeTrainingSettings(dstDir.absoluteFilePath("Settings.json"));
+    if (!ui->networkOption->isChecked()) {
         if (!dstDir.mkdir(trainingSettings.sectionsPath)) {
             QMessageBox::warning(this, "Ошибка при сохранении",
                                  "Не удалось создать папку для разделов.");
             return false;
         }
 
-        const auto& sections = getSections();
         auto sectionsDstPath = dstDir.absoluteFilePath(trainingSettings.sectionsPath);
-        for (int i = 0; i < ui->sectionsListWidget->count(); ++i) {
-            QListWidgetItem* item = ui->sectionsListWidget->item(i);
-            if (item->checkState() != Qt::Checked)
-                continue;
-            const auto& section = sections[item->data(Qt::UserRole).toUuid()];
+        foreach (const auto& section, selectedSections()) {
             QFileInfo sectionSrcFileInfo(section.path);
             QString sectionDstPath = getNewDir(sectionsDstPath, sectionSrcFileInfo.baseName());
             QDir sectionDstDir(sectionDstPath);
             QString sectionDstFileName = sectionDstDir.absoluteFilePath(
                         sectionSrcFileInfo.fileName());
-            if (!section.saveAs(sectionDstFileName).isValid()) {
+            if (!section.saveAs(sectionDstFileName, sectionsDstPath).isValid()) {
                 QMessageBox::warning(this, "Ошибка при сохранении",
                                      "Не удалось записать разделы тренажера.");
                 return false;
@@ -316,6 +288,86 @@ bool TrainingCreationWizard::saveDirectory(QString path)
         }
     }
 
+    if (hasGroupsInPackage()) {
+        if (!dstDir.mkdir("localData")) {
+            QMessageBox::warning(this, "Ошибка при сохранении",
+                                 "Не удалось записать список групп.");
+            return false;
+        }
+        auto localDataDir = dstDir;
+        localDataDir.cd("localData");
+        if (!Group::save(selectedGroups(trainingSettings),
+                         localDataDir.absoluteFilePath("Groups.json"))) {
+            QMessageBox::warning(this, "Ошибка при сохранении",
+                                 "Не удалось записать список групп.");
+            return false;
+        }
+    }
+
+    if (!trainingSettings.write()) {
+        QMessageBox::warning(this, "Ошибка при сохранении",
+                             "Не удалось записать настройки тренажера.");
+        return false;
+    }
+    return true;
+}
+
+bool TrainingCreationWizard::saveArchive(QString path)
+{
+    // Generated files go first: files with the same names from the program
+    // dir are skipped by the builder
+    ZipBuilder builder;
+    builder.threadCount = Settings::instance().archiveThreadCount;
+    builder.compressionLevel = Settings::instance().archiveCompressionLevel;
+    auto trainingSettings = makeTrainingSettings(QString());
+    builder.addData(QJsonDocument(trainingSettings.toJson()).toJson(), "Settings.json");
+    if (hasGroupsInPackage()) {
+        builder.addData(QJsonDocument(Group::toJson(selectedGroups(trainingSettings))).toJson(),
+                        "localData/Groups.json");
+    }
+
+    if (!ui->networkOption->isChecked()) {
+        foreach (const auto& section, selectedSections()) {
+            QFileInfo sectionSrcFileInfo(section.path);
+            QString sectionDstPath = builder.newDirPath(
+                        trainingSettings.sectionsPath, sectionSrcFileInfo.baseName());
+            if (sectionDstPath.isEmpty()
+                || !section.addTo(builder, sectionDstPath + "/" + sectionSrcFileInfo.fileName(),
+                                  trainingSettings.sectionsPath)) {
+                QMessageBox::warning(this, "Ошибка при сохранении",
+                                     "Не удалось записать разделы тренажера.");
+                return false;
+            }
+        }
+    }
+
+    if (!builder.addDir(TRAINING_SRC_DIR, "")) {
+        QMessageBox::warning(this, "Ошибка при сохранении",
+                             "Не удалось скопировать программу-тренажер и ее зависимости.");
+        return false;
+    }
+    if (!builder.write(path)) {
+        QMessageBox::warning(this, "Ошибка при сохранении",
+                             "Не удалось создать архив с тренажером.");
+        return false;
+    }
+    return true;
+}
+
+TrainingSettings TrainingCreationWizard::makeTrainingSettings(QString path) const
+{
+    const auto& settings = Settings::instance();
+    TrainingSettings trainingSettings(path);
+    if (ui->networkOption->isChecked()) {
+        trainingSettings.solutionsPath = settings.solutionsPath;
+        trainingSettings.sectionsPath = settings.sectionsPath;
+        if (!settings.groupsPath.isEmpty())
+            trainingSettings.groupsPath = settings.groupsPath;
+    } else {
+        trainingSettings.solutionsPath = "";
+        trainingSettings.sectionsPath = "sections";
+    }
+
     if (ui->groupsBox->isChecked()) {
         if (ui->selectGroupsButton->isChecked()) {
             trainingSettings.areAllGroupsAllowed = false;
@@ -328,7 +380,6 @@ bool TrainingCreationWizard::saveDirectory(QString path)
             trainingSettings.areAllGroupsAllowed = true;
         }
     } else {
-        saveGroupsToPackage = false;
         trainingSettings.groupsPath = "";
         trainingSettings.areAllGroupsAllowed = false;
         trainingSettings.customGroups.clear();
@@ -342,38 +393,41 @@ bool TrainingCreationWizard::saveDirectory(QString path)
     } else {
         trainingSettings.loginType = LoginType::OnlyFromGroup;
     }
+    return trainingSettings;
+}
 
-    if (saveGroupsToPackage) {
-        if (!dstDir.mkdir("localData")) {
-            QMessageBox::warning(this, "Ошибка при сохранении",
-                                 "Не удалось записать список групп.");
-            return false;
-        }
-        auto localDataDir = dstDir;
-        localDataDir.cd("localData");
-        auto groups = getGroups();
-        if (ui->selectGroupsButton->isChecked()) {
-            auto groupSet = QSet<QUuid>::fromList(trainingSettings.customGroups);
-            QList<Group> filteredGroups;
-            for (const auto& group : groups) {
-                if (groupSet.contains(group.id))
-                    filteredGroups.append(group);
-            }
-            groups.swap(filteredGroups);
-        }
-        if (!Group::save(groups, localDataDir.absoluteFilePath("Groups.json"))) {
-            QMessageBox::warning(this, "Ошибка при сохранении",
-                                 "Не удалось записать список групп.");
-            return false;
-        }
+bool TrainingCreationWizard::hasGroupsInPackage() const
+{
+    if (!ui->groupsBox->isChecked())
+        return false;
+    return !ui->networkOption->isChecked() || Settings::instance().groupsPath.isEmpty();
+}
+
+QList<Section> TrainingCreationWizard::selectedSections() const
+{
+    QList<Section> result;
+    const auto& sections = getSections();
+    for (int i = 0; i < ui->sectionsListWidget->count(); ++i) {
+        QListWidgetItem* item = ui->sectionsListWidget->item(i);
+        if (item->checkState() == Qt::Checked)
+            result.append(sections[item->data(Qt::UserRole).toUuid()]);
     }
+    return result;
+}
 
-    if (!trainingSettings.write()) {
-        QMessageBox::warning(this, "Ошибка при сохранении",
-                             "Не удалось записать настройки тренажера.");
-        return false;
+QList<Group> TrainingCreationWizard::selectedGroups(const TrainingSettings& trainingSettings) const
+{
+    auto groups = getGroups();
+    if (ui->selectGroupsButton->isChecked()) {
+        auto groupSet = QSet<QUuid>::fromList(trainingSettings.customGroups);
+        QList<Group> filteredGroups;
+        for (const auto& group : groups) {
+            if (groupSet.contains(group.id))
+                filteredGroups.append(group);
+        }
+        groups.swap(filteredGroups);
     }
-    return true;
+    return groups;
 }
 
 void TrainingCreationWizard::on_selectGroupsButton_toggled(bool checked)
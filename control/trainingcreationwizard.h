@@ -1,6 +1,9 @@
 #ifndef TRAININGCREATIONWIZARD_H
 #define TRAININGCREATIONWIZARD_H
 
+#include <omkit/group.h>
+#include <omkit/section.h>
+#include <omkit/trainingsettings.h>
 #include <QDialog>
 
 namespace Ui {
@@ -34,6 +37,11 @@ private:
     void goTo(QWidget* nextPage);
     void updateButtons();
     bool saveDirectory(QString path);
+    bool saveArchive(QString path);
+    TrainingSettings makeTrainingSettings(QString path) const;
+    bool hasGroupsInPackage() const;
+    QList<Section> selectedSections() const;
+    QList<Group> selectedGroups(const TrainingSettings& trainingSettings) const;
 
     Ui::TrainingCreationWizard *ui;
     QList<QWidget*> prevPages;
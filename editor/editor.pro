@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -30,7 +30,9 @@ SOURCES += main.cpp\
     aboutdialog.cpp \
     richtextedit.cpp \
     exportdialog.cpp \
-    imageinsertiondialog.cpp
+    imageinsertiondialog.cpp \
+    textsearch.cpp \
+    searchform.cpp
 
 HEADERS  += mainwindow.h \
     sectionsform.h \
@@ -44,7 +46,9 @@ HEADERS  += mainwindow.h \
     aboutdialog.h \
     richtextedit.h \
     exportdialog.h \
-    imageinsertiondialog.h
+    imageinsertiondialog.h \
+    textsearch.h \
+    searchform.h
 
 FORMS    += mainwindow.ui \
     sectionsform.ui \
@@ -55,7 +59,8 @@ FORMS    += mainwindow.ui \
     texteditorpage.ui \
     aboutdialog.ui \
     exportdialog.ui \
-    imageinsertiondialog.ui
+    imageinsertiondialog.ui \
+    searchform.ui
 
 RESOURCES += \
     resources.qrc
@@ -6,7 +6,6 @@
 #include <omkit/zip_utils.h>
 #include <omkit/ui_utils.h>
 #include <QFileDialog>
-#include <QTemporaryDir>
 #include <QMessageBox>
 
 ExportDialog::ExportDialog(QWidget *parent) :
@@ -54,28 +53,22 @@ void ExportDialog::accept()
         return;
     }
 
-    QTemporaryDir tempDir;
-    if (!tempDir.isValid()) {
-        QMessageBox::warning(this, "Ошибка при сохранении",
-                             "Невозможно создать временную папку для разделов.");
-        return;
-    }
-
     QHash<QUuid, Section> sectionMap;
     foreach (const auto& section, getSections())
         sectionMap[section.id] = section;
 
+    ZipBuilder builder;
+    builder.threadCount = Settings::instance().archiveThreadCount;
+    builder.compressionLevel = Settings::instance().archiveCompressionLevel;
     for (int i = 0; i < ui->listWidget->count(); ++i) {
         QListWidgetItem* item = ui->listWidget->item(i);
         if (item->checkState() != Qt::Checked)
             continue;
         const auto& section = sectionMap[item->data(Qt::UserRole).toUuid()];
         QFileInfo sectionSrcFileInfo(section.path);
-        QString sectionDstPath = getNewDir(tempDir.path(), sectionSrcFileInfo.baseName());
-        QDir sectionDstDir(sectionDstPath);
-        QString sectionDstFileName = sectionDstDir.absoluteFilePath(
-                    sectionSrcFileInfo.fileName());
-        if (!section.saveAs(sectionDstFileName).isValid()) {
+        QString sectionDstPath = builder.newDirPath("", sectionSrcFileInfo.baseName());
+        if (sectionDstPath.isEmpty()
+            || !section.addTo(builder, sectionDstPath + "/" + sectionSrcFileInfo.fileName(), ".")) {
             QMessageBox::warning(this, "Ошибка при сохранении",
                                  "Не удалось записать один из разделов.");
             return;
@@ -83,7 +76,7 @@ void ExportDialog::accept()
     }
 
     QString path = ui->pathEdit->text();
-    if (!compress(tempDir.path(), path)) {
+    if (!builder.write(path)) {
         QMessageBox::warning(this, "Ошибка при сохранении",
                              "Не удалось создать архив с разделами. Проверьте правильность"
                              " написания пути.");
@@ -1,6 +1,7 @@
 #include "imageinsertiondialog.h"
 #include "ui_imageinsertiondialog.h"
 #include "settings.h"
+#include <omkit/imagestore.h>
 #include <omkit/utils.h>
 #include <QPixmap>
 #include <QFileDialog>
@@ -22,14 +23,16 @@ void ImageInsertionDialog::init(QDir sectionDir, const CaseImage& image)
 {
     this->sectionDir = sectionDir;
     isImageCopyNeeded = false;
+    imageHash = image.hash;
     if (image.isEmpty()) {
         resetImage();
         return;
     }
-    if (!setImage(sectionDir, image.fileName, image.width, image.height)) {
+    if (!setImage(QDir(), image.filePath(sectionDir), image.width, image.height)) {
         resetImage();
         return;
     }
+    ui->nameEdit->setText(image.fileName);
     updateSizes();
     updateRatio();
 
@@ -49,6 +52,7 @@ CaseImage ImageInsertionDialog::result() const
 {
     CaseImage image;
     image.fileName = ui->nameEdit->text();
+    image.hash = imageHash;
     if (ui->alignLeftButton->isChecked())
         image.horAlign = CaseImage::HorAlign::Left;
     if (ui->alignCenterButton->isChecked())
@@ -67,18 +71,15 @@ CaseImage ImageInsertionDialog::result() const
 void ImageInsertionDialog::accept()
 {
     if (isImageCopyNeeded) {
-        auto newPath = getNewFileName(sectionDir.absolutePath(), ui->nameEdit->text());
-        if (newPath.isEmpty()) {
+        CaseImage image;
+        image.fileName = QFileInfo(ui->nameEdit->text()).fileName();
+        if (!ImageStore(sectionDir).add(ui->nameEdit->text(), image)) {
             QMessageBox::warning(this, "Ошибка при сохранении файла",
                                  "Невозможно сохранить изображение в раздел");
             return;
         }
-        if (!QFile::copy(ui->nameEdit->text(), newPath)) {
-            QMessageBox::warning(this, "Ошибка при сохранении файла",
-                                 "Невозможно сохранить изображение в раздел");
-            return;
-        }
-        ui->nameEdit->setText(QFileInfo(newPath).fileName());
+        imageHash = image.hash;
+        ui->nameEdit->setText(image.fileName);
     }
     QDialog::accept();
 }
@@ -86,6 +87,7 @@ void ImageInsertionDialog::accept()
 void ImageInsertionDialog::resetImage()
 {
     ui->nameEdit->setText("");
+    imageHash.clear();
     setOptionsEnabled(false);
     ui->imagePreview->setText("Нет изображения");
     ui->imagePreview->setPixmap(QPixmap());
@@ -159,6 +161,7 @@ void ImageInsertionDialog::on_chooseButton_clicked()
             return;
         }
         isImageCopyNeeded = true;
+        imageHash.clear();
         updateSizes();
         updateRatio();
         ui->lockButton->setChecked(true);
@@ -46,6 +46,7 @@ private:
     QDir sectionDir;
     QPixmap originalPixmap;
     bool isImageCopyNeeded;
+    QString imageHash;
     bool ignoreSizeChanges = true;
     float ratio;
 };
@@ -8,6 +8,7 @@
 #include "richtextedit.h"
 #include "exportdialog.h"
 #include "imageinsertiondialog.h"
+#include "searchform.h"
 #include "ui_mainwindow.h"
 
 #include <omkit/utils.h>
@@ -22,6 +23,7 @@
 #include <QClipboard>
 #include <QMimeData>
 #include <QTextList>
+#include <QDockWidget>
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
@@ -55,6 +57,13 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(sectionsForm, SIGNAL(requestedCreation()), this, SLOT(create()));
     connect(sectionsForm, SIGNAL(requestedOpen(Section)), this, SLOT(openSection(Section)));
 
+    searchForm = new SearchForm(this);
+    searchDock = new QDockWidget("Поиск по разделам", this);
+    searchDock->setWidget(searchForm);
+    searchDock->hide();
+    addDockWidget(Qt::BottomDockWidgetArea, searchDock);
+    connect(searchForm, SIGNAL(requestedOpen(Section)), this, SLOT(openSection(Section)));
+
     connect(ui->createAction, SIGNAL(triggered()), this, SLOT(create()));
     connect(ui->openAction, SIGNAL(triggered()), this, SLOT(open()));
     connect(ui->saveAction, SIGNAL(triggered()), this, SLOT(save()));
@@ -83,6 +92,7 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(ui->removeCaseAction, SIGNAL(triggered()), this, SLOT(removeCase()));
     connect(ui->exportSectionsAction, SIGNAL(triggered()), this, SLOT(showExportDialog()));
     connect(ui->imageMenuAction, SIGNAL(triggered()), this, SLOT(showImageMenu()));
+    connect(ui->searchAction, SIGNAL(triggered()), this, SLOT(showSearch()));
 
     QTimer::singleShot(0, this, SLOT(loadSettings()));
 }
@@ -359,6 +369,7 @@ void MainWindow::openSection(const Section& section)
     ui->tabWidget->addTab(sectionEditForm, trim(section.name, 16));
     ui->tabWidget->setCurrentWidget(sectionEditForm);
     openedPages[section.id] = sectionEditForm;
+    searchForm->setOpenedSections(openedPages.keys().toSet());
 
     connect(sectionEditForm, SIGNAL(sectionSaved(Section)),
             this, SLOT(onSectionSaved(Section)));
@@ -390,6 +401,13 @@ void MainWindow::showExportDialog()
     exportDialog->exec();
 }
 
+void MainWindow::showSearch()
+{
+    searchDock->show();
+    searchDock->raise();
+    searchForm->focusQuery();
+}
+
 void MainWindow::onSectionSaved(const Section& section)
 {
     auto widget = openedPages[section.id];
@@ -593,6 +611,7 @@ bool MainWindow::closePage(SectionEditForm* sectionEditForm)
     }
     auto id = sectionEditForm->sectionId();
     openedPages.remove(id);
+    searchForm->setOpenedSections(openedPages.keys().toSet());
     delete sectionEditForm;
     return true;
 }
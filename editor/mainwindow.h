@@ -16,6 +16,8 @@ class SectionEditForm;
 class RichTextEdit;
 class ExportDialog;
 class ImageInsertionDialog;
+class SearchForm;
+class QDockWidget;
 class QFontComboBox;
 class QComboBox;
 
@@ -52,6 +54,7 @@ private slots:
     void loadSettings();
     void openSection(const Section& section);
     void showExportDialog();
+    void showSearch();
     void onSectionSaved(const Section& section);
     void onCaseInFocus(bool inFocus);
     void onTextEditInFocus(bool inFocus);
@@ -91,6 +94,8 @@ private:
     AboutDialog* aboutDialog = nullptr;
     ExportDialog* exportDialog = nullptr;
     ImageInsertionDialog* imageInsertionDialog = nullptr;
+    SearchForm* searchForm;
+    QDockWidget* searchDock;
     QHash<QUuid, QWidget*> openedPages;
 };
 
@@ -0,0 +1,145 @@
+#include "searchform.h"
+#include "section_utils.h"
+#include "ui_searchform.h"
+#include <QMessageBox>
+
+namespace {
+QString fileTitle(const TextSearch::FileRef& file)
+{
+    switch (file.kind) {
+    case TextSearch::FileKind::Question:
+        return "Кейс " + QString::number(file.caseIndex + 1) + " \"" + file.caseName + "\", вопрос";
+    case TextSearch::FileKind::Answer:
+        return "Кейс " + QString::number(file.caseIndex + 1) + " \"" + file.caseName + "\", ответ";
+    case TextSearch::FileKind::Total:
+        return "Итог";
+    }
+    return QString();
+}
+} // namespace
+
+SearchForm::SearchForm(QWidget *parent) :
+    QWidget(parent),
+    ui(new Ui::SearchForm),
+    search(new TextSearch(this)),
+    isReplace(false),
+    matchesNum(0),
+    failedNum(0),
+    skippedNum(0)
+{
+    ui->setupUi(this);
+    connect(ui->findEdit, SIGNAL(returnPressed()), this, SLOT(on_findButton_clicked()));
+    connect(search, SIGNAL(found(TextSearch::Hit)), this, SLOT(onFound(TextSearch::Hit)));
+    connect(search, SIGNAL(finished()), this, SLOT(onFinished()));
+}
+
+SearchForm::~SearchForm()
+{
+    delete ui;
+}
+
+void SearchForm::setOpenedSections(const QSet<QUuid>& ids)
+{
+    openedSections = ids;
+}
+
+void SearchForm::focusQuery()
+{
+    ui->findEdit->setFocus();
+    ui->findEdit->selectAll();
+}
+
+void SearchForm::onFound(const TextSearch::Hit& hit)
+{
+    int row = ui->resultsWidget->rowCount();
+    ui->resultsWidget->insertRow(row);
+    ui->resultsWidget->setItem(row, 0, new QTableWidgetItem(hit.file.sectionName));
+    QString title = fileTitle(hit.file);
+    if (hit.isFailed)
+        title += " (не удалось сохранить)";
+    ui->resultsWidget->setItem(row, 1, new QTableWidgetItem(title));
+    ui->resultsWidget->setItem(row, 2, new QTableWidgetItem(QString::number(hit.matchesNum)));
+    ui->resultsWidget->setItem(row, 3, new QTableWidgetItem(hit.context));
+    ui->resultsWidget->item(row, 1)->setToolTip(hit.file.filePath);
+    rowSectionPaths.append(hit.file.sectionPath);
+    matchesNum += hit.matchesNum;
+    if (hit.isFailed)
+        ++failedNum;
+}
+
+void SearchForm::onFinished()
+{
+    ui->findButton->setEnabled(true);
+    ui->replaceButton->setEnabled(true);
+    ui->cancelButton->setEnabled(false);
+    int filesNum = ui->resultsWidget->rowCount();
+    QString status = (isReplace ? "Заменено совпадений: " : "Найдено совпадений: ")
+            + QString::number(matchesNum) + " в файлах: " + QString::number(filesNum)
+            + " из " + QString::number(search->filesNum());
+    if (failedNum > 0)
+        status += ". Не удалось сохранить файлов: " + QString::number(failedNum);
+    if (skippedNum > 0)
+        status += ". Пропущено открытых разделов: " + QString::number(skippedNum);
+    ui->statusLabel->setText(status);
+    ui->resultsWidget->resizeColumnsToContents();
+}
+
+void SearchForm::on_findButton_clicked()
+{
+    if (ui->findEdit->text().isEmpty() || search->isRunning())
+        return;
+    isReplace = false;
+    prepare();
+    auto cs = ui->caseSensitiveCheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    search->find(getSections(), ui->findEdit->text(), cs);
+}
+
+void SearchForm::on_replaceButton_clicked()
+{
+    if (ui->findEdit->text().isEmpty() || search->isRunning())
+        return;
+    int answer = QMessageBox::question(
+                this, "Замена",
+                "Заменить \"" + ui->findEdit->text() + "\" на \"" + ui->replaceEdit->text()
+                + "\" во всех разделах? Разделы, открытые для редактирования, изменены не будут.",
+                QMessageBox::Yes, QMessageBox::No);
+    if (answer != QMessageBox::Yes)
+        return;
+
+    isReplace = true;
+    prepare();
+    QList<Section> sections;
+    foreach (const auto& section, getSections()) {
+        if (openedSections.contains(section.id))
+            ++skippedNum;
+        else
+            sections.append(section);
+    }
+    auto cs = ui->caseSensitiveCheckBox->isChecked() ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    search->replace(sections, ui->findEdit->text(), ui->replaceEdit->text(), cs);
+}
+
+void SearchForm::on_cancelButton_clicked()
+{
+    search->cancel();
+}
+
+void SearchForm::on_resultsWidget_cellDoubleClicked(int row, int /*column*/)
+{
+    QString path = rowSectionPaths.value(row);
+    if (!path.isEmpty() && isKnownSection(path))
+        emit requestedOpen(getSection(path));
+}
+
+void SearchForm::prepare()
+{
+    ui->resultsWidget->setRowCount(0);
+    rowSectionPaths.clear();
+    matchesNum = 0;
+    failedNum = 0;
+    skippedNum = 0;
+    ui->findButton->setEnabled(false);
+    ui->replaceButton->setEnabled(false);
+    ui->cancelButton->setEnabled(true);
+    ui->statusLabel->setText(isReplace ? "Замена..." : "Поиск...");
+}
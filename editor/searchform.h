@@ -0,0 +1,51 @@
+#ifndef SEARCHFORM_H
+#define SEARCHFORM_H
+
+#include "textsearch.h"
+
+#include <QWidget>
+#include <QSet>
+#include <QUuid>
+
+namespace Ui {
+class SearchForm;
+}
+
+class SearchForm : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit SearchForm(QWidget *parent = 0);
+    ~SearchForm();
+
+    // Sections opened for editing are not changed by a replace
+    void setOpenedSections(const QSet<QUuid>& ids);
+    void focusQuery();
+
+signals:
+    void requestedOpen(Section);
+
+private slots:
+    void onFound(const TextSearch::Hit& hit);
+    void onFinished();
+    void on_findButton_clicked();
+    void on_replaceButton_clicked();
+    void on_cancelButton_clicked();
+    void on_resultsWidget_cellDoubleClicked(int row, int column);
+
+private:
+    void prepare();
+
+    Ui::SearchForm *ui;
+
+    TextSearch* search;
+    QSet<QUuid> openedSections;
+    QList<QString> rowSectionPaths;
+    bool isReplace;
+    int matchesNum;
+    int failedNum;
+    int skippedNum;
+};
+
+#endif // SEARCHFORM_H
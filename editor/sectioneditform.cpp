@@ -483,7 +483,8 @@ void SectionEditForm::connectPage(TextEditorPage* page)
 
 void SectionEditForm::removeImage(const CaseImage& caseImage)
 {
-    if (caseImage.isEmpty())
+    // Images in the store may be used by other sections
+    if (caseImage.isEmpty() || !caseImage.hash.isEmpty())
         return;
     QFile::remove(originalSection.dir().absoluteFilePath(caseImage.fileName));
 }
@@ -24,6 +24,9 @@ void Settings::read()
         return;
 
     lastDirectoryPath = rootObj["lastDirectoryPath"].toString(lastDirectoryPath);
+    archiveThreadCount = qMax(0, rootObj["archiveThreadCount"].toInt(archiveThreadCount));
+    archiveCompressionLevel = qBound(-1, rootObj["archiveCompressionLevel"]
+                                     .toInt(archiveCompressionLevel), 9);
 
     QJsonArray knownSectionsArray = rootObj["knownSections"].toArray();
     knownSections.clear();
@@ -36,6 +39,8 @@ void Settings::write()
 {
     QJsonObject rootObj;
     rootObj["lastDirectoryPath"] = lastDirectoryPath;
+    rootObj["archiveThreadCount"] = archiveThreadCount;
+    rootObj["archiveCompressionLevel"] = archiveCompressionLevel;
 
     QJsonArray knownSectionsArray;
     foreach (auto knownSection, knownSections)
@@ -65,6 +70,8 @@ void Settings::updateLastDirectoryPath(QString path)
 }
 
 Settings::Settings()
+    : archiveThreadCount(0)
+    , archiveCompressionLevel(-1)
 {
     lastDirectoryPath = QDir::homePath();
 }
@@ -16,6 +16,9 @@ public:
 
     QString lastDirectoryPath;
     QList<QString> knownSections;
+    // Passed to ZipBuilder for export archives
+    int archiveThreadCount;
+    int archiveCompressionLevel;
 
 private:
     Settings();
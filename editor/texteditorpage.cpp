@@ -106,7 +106,7 @@ void TextEditorPage::setImage(const CaseImage& image)
                 "Положение изображения: <b>%4 %5</b>")
                 .arg(image.fileName).arg(image.width).arg(image.height)
                 .arg(toString(image.vertAlign)).arg(toString(image.horAlign)));
-    QPixmap pixmap(dir.absoluteFilePath(image.fileName));
+    QPixmap pixmap(image.filePath(dir));
     if (pixmap.isNull())
         return;
     ui->imagePreview->setPixmap(pixmap.scaled(150, 100, Qt::KeepAspectRatio,
@@ -0,0 +1,230 @@
+#include "textsearch.h"
+#include <QFile>
+#include <QHash>
+#include <QSaveFile>
+#include <QTextCodec>
+#include <QVector>
+#include <QtConcurrent>
+
+namespace {
+const int CONTEXT_SIZE = 40;
+
+QList<TextSearch::FileRef> collectFiles(const QList<Section>& sections)
+{
+    QList<TextSearch::FileRef> files;
+    foreach (const auto& section, sections) {
+        QDir dir = section.dir();
+        for (int i = 0; i < section.cases.size(); ++i) {
+            const auto& caseValue = section.cases[i];
+            TextSearch::FileRef file{ section.path, section.name, i, caseValue.name,
+                                      TextSearch::FileKind::Question,
+                                      dir.absoluteFilePath(caseValue.questionFileName) };
+            files.append(file);
+            file.kind = TextSearch::FileKind::Answer;
+            file.filePath = dir.absoluteFilePath(caseValue.answerFileName);
+            files.append(file);
+        }
+        if (!section.totalFileName.isEmpty()) {
+            files.append(TextSearch::FileRef{ section.path, section.name, -1, QString(),
+                                              TextSearch::FileKind::Total,
+                                              dir.absoluteFilePath(section.totalFileName) });
+        }
+    }
+    return files;
+}
+
+// Decodes the character references of a run of HTML text. starts[i] is the
+// position in the run of the reference or character that gave text[i], the
+// last item is the run size. References that are not known are kept as they
+// are, so that text around a match is written back unchanged.
+void decodeRun(const QString& run, QString& text, QVector<int>& starts)
+{
+    static const QHash<QString, QChar> ENTITIES{
+        { "amp", '&' }, { "lt", '<' }, { "gt", '>' }, { "quot", '"' },
+        { "apos", '\'' }, { "nbsp", ' ' }
+    };
+    text.clear();
+    starts.clear();
+    text.reserve(run.size());
+    starts.reserve(run.size() + 1);
+    int pos = 0;
+    while (pos < run.size()) {
+        int end = run[pos] == '&' ? run.indexOf(';', pos) : -1;
+        if (end != -1 && end - pos <= 10) {
+            QString entity = run.mid(pos + 1, end - pos - 1);
+            QString decoded;
+            if (entity.startsWith('#')) {
+                bool isOk;
+                uint code = entity.startsWith("#x", Qt::CaseInsensitive)
+                        ? entity.mid(2).toUInt(&isOk, 16)
+                        : entity.mid(1).toUInt(&isOk);
+                if (isOk && code > 0 && code <= 0x10FFFF)
+                    decoded = QString::fromUcs4(&code, 1);
+            } else if (ENTITIES.contains(entity)) {
+                decoded = ENTITIES[entity];
+            }
+            if (!decoded.isEmpty()) {
+                foreach (QChar c, decoded) {
+                    text.append(c);
+                    starts.append(pos);
+                }
+                pos = end + 1;
+                continue;
+            }
+        }
+        text.append(run[pos]);
+        starts.append(pos);
+        ++pos;
+    }
+    starts.append(run.size());
+}
+
+QString tagNameAt(const QString& html, int pos, int end)
+{
+    return html.mid(pos + 1, end - pos - 1).trimmed().section(' ', 0, 0).toLower();
+}
+
+struct FileProcessor {
+    typedef TextSearch::Hit result_type;
+
+    TextSearch::Hit operator()(const TextSearch::FileRef& file) const
+    {
+        TextSearch::Hit hit{ file, 0, QString(), false };
+        QFile inFile(file.filePath);
+        if (!inFile.open(QIODevice::ReadOnly))
+            return hit;
+        QByteArray data = inFile.readAll();
+        inFile.close();
+        QTextCodec* codec = Qt::codecForHtml(data);
+        QString html = codec->toUnicode(data);
+
+        QString newHtml;
+        if (isReplace)
+            newHtml.reserve(html.size());
+        int pos = 0;
+        while (pos < html.size()) {
+            if (html[pos] == '<') {
+                int end = html.indexOf('>', pos);
+                end = end == -1 ? html.size() : end + 1;
+                QString tagName = tagNameAt(html, pos, end - 1);
+                // Styles and scripts are not text
+                if (tagName == "head" || tagName == "style" || tagName == "script") {
+                    int closeTag = html.indexOf("</" + tagName, end, Qt::CaseInsensitive);
+                    int closeEnd = closeTag == -1 ? -1 : html.indexOf('>', closeTag);
+                    end = closeEnd == -1 ? html.size() : closeEnd + 1;
+                }
+                if (isReplace)
+                    newHtml.append(html.midRef(pos, end - pos));
+                pos = end;
+                continue;
+            }
+            int end = html.indexOf('<', pos);
+            if (end == -1)
+                end = html.size();
+            QString run = html.mid(pos, end - pos);
+            processRun(run, hit, newHtml);
+            pos = end;
+        }
+
+        if (isReplace && hit.matchesNum > 0) {
+            QSaveFile outFile(file.filePath);
+            hit.isFailed = !outFile.open(QIODevice::WriteOnly)
+                    || outFile.write(codec->fromUnicode(newHtml)) == -1
+                    || !outFile.commit();
+        }
+        return hit;
+    }
+
+    void processRun(const QString& run, TextSearch::Hit& hit, QString& newHtml) const
+    {
+        QString text;
+        QVector<int> starts;
+        decodeRun(run, text, starts);
+        // Only the matches are rewritten, the markup between them is copied
+        int copiedPos = 0;
+        for (int i = text.indexOf(this->text, 0, cs); i != -1;
+             i = text.indexOf(this->text, i + this->text.size(), cs)) {
+            if (hit.context.isEmpty()) {
+                int start = qMax(0, i - CONTEXT_SIZE);
+                hit.context = text.mid(start, i - start + this->text.size() + CONTEXT_SIZE)
+                        .simplified();
+            }
+            ++hit.matchesNum;
+            if (isReplace) {
+                newHtml.append(run.midRef(copiedPos, starts[i] - copiedPos));
+                newHtml.append(replacement.toHtmlEscaped());
+                copiedPos = starts[i + this->text.size()];
+            }
+        }
+        if (isReplace)
+            newHtml.append(run.midRef(copiedPos));
+    }
+
+    QString text;
+    QString replacement;
+    bool isReplace;
+    Qt::CaseSensitivity cs;
+};
+} // namespace
+
+TextSearch::TextSearch(QObject* parent)
+    : QObject(parent)
+    , watcher(new QFutureWatcher<Hit>(this))
+    , filesCount(0)
+{
+    connect(watcher, SIGNAL(resultsReadyAt(int,int)), this, SLOT(onResultsReady(int,int)));
+    connect(watcher, SIGNAL(finished()), this, SIGNAL(finished()));
+}
+
+TextSearch::~TextSearch()
+{
+    // A replace that has started writing files is allowed to finish them
+    watcher->cancel();
+    watcher->waitForFinished();
+}
+
+void TextSearch::find(const QList<Section>& sections, QString text, Qt::CaseSensitivity cs)
+{
+    start(sections, text, QString(), false, cs);
+}
+
+void TextSearch::replace(const QList<Section>& sections, QString text, QString replacement,
+                         Qt::CaseSensitivity cs)
+{
+    start(sections, text, replacement, true, cs);
+}
+
+bool TextSearch::isRunning() const
+{
+    return watcher->isRunning();
+}
+
+int TextSearch::filesNum() const
+{
+    return filesCount;
+}
+
+void TextSearch::cancel()
+{
+    watcher->cancel();
+}
+
+void TextSearch::onResultsReady(int begin, int end)
+{
+    for (int i = begin; i < end; ++i) {
+        auto hit = watcher->resultAt(i);
+        if (hit.matchesNum > 0)
+            emit found(hit);
+    }
+}
+
+void TextSearch::start(const QList<Section>& sections, QString text, QString replacement,
+                       bool isReplace, Qt::CaseSensitivity cs)
+{
+    if (watcher->isRunning() || text.isEmpty())
+        return;
+    auto files = collectFiles(sections);
+    filesCount = files.size();
+    watcher->setFuture(QtConcurrent::mapped(
+                           files, FileProcessor{ text, replacement, isReplace, cs }));
+}
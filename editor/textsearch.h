@@ -0,0 +1,70 @@
+#ifndef TEXTSEARCH_H
+#define TEXTSEARCH_H
+
+#include <omkit/section.h>
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QList>
+#include <QString>
+
+// Searches the question, answer and total files of sections for a phrase
+// on the thread pool and reports the files with matches as they come.
+// Matches are looked for in the text of the HTML, not in tags, and can not
+// span formatting changes. A replace rewrites only the files with matches.
+class TextSearch : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class FileKind {
+        Question,
+        Answer,
+        Total
+    };
+
+    struct FileRef {
+        QString sectionPath;
+        QString sectionName;
+        int caseIndex;
+        QString caseName;
+        FileKind kind;
+        QString filePath;
+    };
+
+    struct Hit {
+        FileRef file;
+        int matchesNum;
+        QString context;
+        // Set if a replace could not write the file
+        bool isFailed;
+    };
+
+    explicit TextSearch(QObject* parent = 0);
+    ~TextSearch();
+
+    void find(const QList<Section>& sections, QString text, Qt::CaseSensitivity cs);
+    void replace(const QList<Section>& sections, QString text, QString replacement,
+                 Qt::CaseSensitivity cs);
+    bool isRunning() const;
+    int filesNum() const;
+
+signals:
+    void found(const TextSearch::Hit& hit);
+    void finished();
+
+public slots:
+    void cancel();
+
+private slots:
+    void onResultsReady(int begin, int end);
+
+private:
+    void start(const QList<Section>& sections, QString text, QString replacement,
+               bool isReplace, Qt::CaseSensitivity cs);
+
+    QFutureWatcher<Hit>* watcher;
+    int filesCount;
+};
+
+#endif // TEXTSEARCH_H
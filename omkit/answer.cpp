@@ -24,6 +24,7 @@ Answer Answer::fromJson(const QJsonObject& jsonObject)
     answer.caseId = QUuid(jsonObject["caseId"].toString(""));
     answer.fileName = jsonObject["fileName"].toString("");
     answer.version = jsonObject["version"].toInt(FINAL_VERSION);
+    answer.hash = jsonObject["hash"].toString("");
     return answer;
 }
 
@@ -33,6 +34,8 @@ QJsonObject Answer::toJson() const
     result["caseId"] = caseId.toString();
     result["fileName"] = fileName;
     result["version"] = version;
+    if (!hash.isEmpty())
+        result["hash"] = hash;
     return result;
 }
 
@@ -25,6 +25,8 @@ public:
     QUuid caseId;
     QString fileName;
     int version;
+    // SHA-1 of the answer file, empty for answers saved by older versions
+    QString hash;
 };
 
 #endif // ANSWER_H
@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Answer lookup benchmark for omkit
+#
+#-------------------------------------------------
+
+QT       += core
+QT       -= gui
+
+TARGET = omkit-bench
+TEMPLATE = app
+
+CONFIG += console
+CONFIG -= app_bundle
+
+SOURCES += main.cpp
+
+win32:CONFIG(release, debug|release): LIBS += -L$$PWD/../../omkit-output/release/ -lomkit
+else:win32:CONFIG(debug, debug|release): LIBS += -L$$PWD/../../omkit-output/debug/ -lomkit
+else:unix: LIBS += -L$$OUT_PWD/../ -lomkit
+
+INCLUDEPATH += $$PWD/../../
+DEPENDPATH += $$PWD/../
@@ -0,0 +1,105 @@
+#include <omkit/case.h>
+#include <omkit/answer.h>
+#include <omkit/solution.h>
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QList>
+#include <QTextStream>
+
+namespace {
+
+const int CASES_NUM = 1000;
+const int SOLUTIONS_NUM = 500;
+
+// The lookup Solution::answer() did before the answers were indexed
+Answer findAnswerByScan(const Solution& solution, const Case& caseValue)
+{
+    foreach (const auto& answer, solution.answers()) {
+        if (answer.caseId == caseValue.id)
+            return answer;
+    }
+    return Answer();
+}
+
+int countFinalByScan(const Solution& solution)
+{
+    int count = 0;
+    foreach (const auto& answer, solution.answers()) {
+        if (answer.isFinal())
+            count++;
+    }
+    return count;
+}
+
+void printTime(QTextStream& out, QString name, qint64 msecs)
+{
+    out << name.leftJustified(28) << msecs << " ms" << endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+    QTextStream out(stdout);
+
+    QList<Case> cases;
+    for (int i = 0; i < CASES_NUM; i++) {
+        auto caseValue = Case::createCase();
+        caseValue.answerFileName = Case::makeAnswerFileName(QString::number(i + 1));
+        cases.append(caseValue);
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<Solution> solutions;
+    for (int i = 0; i < SOLUTIONS_NUM; i++) {
+        Solution solution;
+        foreach (const auto& caseValue, cases) {
+            auto answer = Answer::createAnswer(caseValue);
+            if (i % 2 == 0)
+                answer.markAsFinal();
+            solution.setAnswer(answer);
+        }
+        solutions.append(solution);
+    }
+    out << CASES_NUM << " cases, " << SOLUTIONS_NUM << " solutions" << endl;
+    printTime(out, "fill with setAnswer()", timer.elapsed());
+
+    // Both passes look cases up in reverse order so that the scan does not
+    // stop early on the first answers
+    int found = 0;
+    timer.restart();
+    foreach (const auto& solution, solutions) {
+        for (int i = cases.size() - 1; i >= 0; i--)
+            found += solution.answer(cases[i]).isValid() ? 1 : 0;
+    }
+    printTime(out, "lookup with answer()", timer.elapsed());
+
+    int scanFound = 0;
+    timer.restart();
+    foreach (const auto& solution, solutions) {
+        for (int i = cases.size() - 1; i >= 0; i--)
+            scanFound += findAnswerByScan(solution, cases[i]).isValid() ? 1 : 0;
+    }
+    printTime(out, "lookup with a linear scan", timer.elapsed());
+
+    int finalNum = 0;
+    timer.restart();
+    foreach (const auto& solution, solutions)
+        finalNum += solution.finalAnswersNum();
+    printTime(out, "finalAnswersNum()", timer.elapsed());
+
+    int scanFinalNum = 0;
+    timer.restart();
+    foreach (const auto& solution, solutions)
+        scanFinalNum += countFinalByScan(solution);
+    printTime(out, "final answers by a scan", timer.elapsed());
+
+    if (found != scanFound || finalNum != scanFinalNum) {
+        out << "lookup results differ" << endl;
+        return 1;
+    }
+    return 0;
+}
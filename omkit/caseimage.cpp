@@ -1,13 +1,19 @@
 #include "caseimage.h"
-#include "smallbimap.h"
+#include "enumnames.h"
 
 namespace {
-const SmallBimap<CaseImage::HorAlign, QString> HOR_ALIGN_NAMES(
-        { CaseImage::HorAlign::Left, CaseImage::HorAlign::Center, CaseImage::HorAlign::Right },
-        { "Left", "Center", "Right" });
-const SmallBimap<CaseImage::VertAlign, QString> VERT_ALIGN_NAMES(
-        { CaseImage::VertAlign::Top, CaseImage::VertAlign::Bottom },
-        { "Top", "Bottom" });
+constexpr EnumNames<CaseImage::HorAlign, 3> HOR_ALIGN_NAMES = {{
+    { CaseImage::HorAlign::Left, "Left" },
+    { CaseImage::HorAlign::Center, "Center" },
+    { CaseImage::HorAlign::Right, "Right" }
+}};
+static_assert(HOR_ALIGN_NAMES.isDense(), "HOR_ALIGN_NAMES must follow HorAlign values");
+
+constexpr EnumNames<CaseImage::VertAlign, 2> VERT_ALIGN_NAMES = {{
+    { CaseImage::VertAlign::Top, "Top" },
+    { CaseImage::VertAlign::Bottom, "Bottom" }
+}};
+static_assert(VERT_ALIGN_NAMES.isDense(), "VERT_ALIGN_NAMES must follow VertAlign values");
 }
 
 CaseImage::CaseImage()
@@ -22,9 +28,10 @@ CaseImage CaseImage::fromJson(const QJsonObject& jsonObject)
 {
     CaseImage image;
     image.fileName = jsonObject["fileName"].toString("");
-    image.horAlign = HOR_ALIGN_NAMES.valueBySecondOr(
+    image.hash = jsonObject["hash"].toString("");
+    image.horAlign = HOR_ALIGN_NAMES.valueOf(
                 jsonObject["horAlign"].toString(), CaseImage::HorAlign::Left);
-    image.vertAlign = VERT_ALIGN_NAMES.valueBySecondOr(
+    image.vertAlign = VERT_ALIGN_NAMES.valueOf(
                 jsonObject["vertAlign"].toString(), CaseImage::VertAlign::Top);
     image.width = jsonObject["width"].toInt(0);
     image.height = jsonObject["height"].toInt(0);
@@ -35,16 +42,26 @@ QJsonObject CaseImage::toJson() const
 {
     QJsonObject result;
     result["fileName"] = fileName;
-    result["horAlign"] = HOR_ALIGN_NAMES.valueByFirst(horAlign);
-    result["vertAlign"] = VERT_ALIGN_NAMES.valueByFirst(vertAlign);
+    if (!hash.isEmpty())
+        result["hash"] = hash;
+    result["horAlign"] = QLatin1String(HOR_ALIGN_NAMES.nameOf(horAlign));
+    result["vertAlign"] = QLatin1String(VERT_ALIGN_NAMES.nameOf(vertAlign));
     result["width"] = width;
     result["height"] = height;
     return result;
 }
 
+QString CaseImage::filePath(QDir sectionDir) const
+{
+    // Stored images are referred to by a path relative to the section dir,
+    // images added before the store existed lie in the section dir itself
+    return QDir::cleanPath(sectionDir.absoluteFilePath(fileName));
+}
+
 bool operator==(const CaseImage& image1, const CaseImage& image2)
 {
     return image1.fileName == image2.fileName
+            && image1.hash == image2.hash
             && image1.horAlign == image2.horAlign
             && image1.vertAlign == image2.vertAlign
             && image1.width == image2.width
@@ -5,6 +5,7 @@
 
 #include <QString>
 #include <QJsonObject>
+#include <QDir>
 
 class OMKITSHARED_EXPORT CaseImage
 {
@@ -15,6 +16,7 @@ public:
 
     static CaseImage fromJson(const QJsonObject& jsonObject);
     QJsonObject toJson() const;
+    QString filePath(QDir sectionDir) const;
 
     enum class HorAlign {
         Left,
@@ -28,6 +30,7 @@ public:
     };
 
     QString fileName;
+    QString hash;
     HorAlign horAlign;
     VertAlign vertAlign;
     int width;
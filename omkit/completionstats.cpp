@@ -0,0 +1,26 @@
+#include "completionstats.h"
+#include "section.h"
+#include "solution.h"
+
+CompletionStats::CompletionStats()
+    : finalAnswersNum(0)
+    , casesNum(0)
+    , percent(0)
+    , isCompleted(false)
+{}
+
+CompletionStats CompletionStats::make(const Section& section, const Solution& solution)
+{
+    CompletionStats stats;
+    stats.casesNum = section.cases.size();
+    // Answers to cases removed from the section do not count
+    foreach (const auto& caseValue, section.cases) {
+        if (solution.answer(caseValue).isFinal())
+            stats.finalAnswersNum++;
+    }
+    stats.percent = stats.casesNum > stats.finalAnswersNum
+            ? static_cast<int>(100.0f * stats.finalAnswersNum / stats.casesNum + 0.5f)
+            : 100;
+    stats.isCompleted = solution.isValid() && stats.finalAnswersNum == stats.casesNum;
+    return stats;
+}
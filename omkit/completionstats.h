@@ -0,0 +1,25 @@
+#ifndef COMPLETIONSTATS_H
+#define COMPLETIONSTATS_H
+
+#include "omkit_global.h"
+
+class Section;
+class Solution;
+
+// Progress of a solution over the current cases of its section. It is
+// derived from both of them, so the apps cache it and drop it only when
+// the answers of the solution or the cases of the section change.
+class OMKITSHARED_EXPORT CompletionStats
+{
+public:
+    CompletionStats();
+
+    static CompletionStats make(const Section& section, const Solution& solution);
+
+    int finalAnswersNum;
+    int casesNum;
+    int percent;
+    bool isCompleted;
+};
+
+#endif // COMPLETIONSTATS_H
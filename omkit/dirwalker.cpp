@@ -0,0 +1,113 @@
+#include "dirwalker.h"
+#include <QDateTime>
+#include <QDir>
+#include <QDirIterator>
+#include <QHash>
+#include <QtConcurrent>
+
+namespace {
+struct DirListing {
+    QFileInfoList files;
+    QStringList dirs;
+};
+
+bool lessThanIgnoreCase(const QString& s1, const QString& s2)
+{
+    return QString::compare(s1, s2, Qt::CaseInsensitive) < 0;
+}
+
+bool fileLessThanIgnoreCase(const QFileInfo& info1, const QFileInfo& info2)
+{
+    return lessThanIgnoreCase(info1.fileName(), info2.fileName());
+}
+
+struct DirLister {
+    typedef DirListing result_type;
+
+    DirListing operator()(const QString& path) const
+    {
+        DirListing listing;
+        // QDirIterator keeps the entry type reported by the directory listing,
+        // so telling files from directories does not need a stat per entry.
+        QDirIterator it(path, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+        while (it.hasNext()) {
+            QString entryPath = it.next();
+            QFileInfo fileInfo = it.fileInfo();
+            if (fileInfo.isDir()) {
+                listing.dirs.append(entryPath);
+            } else if (hasSuffix(fileInfo.fileName())) {
+                if (fetchStamps) {
+                    fileInfo.size();
+                    fileInfo.lastModified();
+                }
+                listing.files.append(fileInfo);
+            }
+        }
+        qSort(listing.files.begin(), listing.files.end(), fileLessThanIgnoreCase);
+        qSort(listing.dirs.begin(), listing.dirs.end(), lessThanIgnoreCase);
+        return listing;
+    }
+
+    bool hasSuffix(const QString& fileName) const
+    {
+        foreach (const auto& suffix, suffixes) {
+            if (fileName.endsWith(suffix, Qt::CaseInsensitive))
+                return true;
+        }
+        return false;
+    }
+
+    QStringList suffixes;
+    bool fetchStamps;
+};
+
+void collect(const QHash<QString, DirListing>& listings, QString path, QFileInfoList& dst)
+{
+    auto it = listings.constFind(path);
+    if (it == listings.cend())
+        return;
+    dst.append(it->files);
+    foreach (const auto& dirPath, it->dirs)
+        collect(listings, dirPath, dst);
+}
+
+QFileInfoList walk(QString rootPath, const QStringList& suffixes, bool fetchStamps)
+{
+    QFileInfoList result;
+    if (!QFileInfo(rootPath).isDir())
+        return result;
+
+    DirLister lister;
+    lister.suffixes = suffixes;
+    lister.fetchStamps = fetchStamps;
+    QString absoluteRootPath = QDir(rootPath).absolutePath();
+    QHash<QString, DirListing> listings;
+    QStringList level(absoluteRootPath);
+    while (!level.isEmpty()) {
+        auto levelListings = QtConcurrent::blockingMapped<QList<DirListing>>(level, lister);
+        QStringList nextLevel;
+        for (int i = 0; i < level.size(); ++i) {
+            const auto& listing = levelListings[i];
+            nextLevel.append(listing.dirs);
+            listings[level[i]] = listing;
+        }
+        level.swap(nextLevel);
+    }
+
+    collect(listings, absoluteRootPath, result);
+    return result;
+}
+} // namespace
+
+QStringList findFiles(QString rootPath, QString suffix)
+{
+    QStringList result;
+    foreach (const auto& fileInfo, walk(rootPath, QStringList(suffix), false))
+        result.append(fileInfo.filePath());
+    return result;
+}
+
+QFileInfoList findFileInfos(QString rootPath, const QStringList& suffixes)
+{
+    return walk(rootPath, suffixes, true);
+}
@@ -0,0 +1,21 @@
+#ifndef DIRWALKER_H
+#define DIRWALKER_H
+
+#include "omkit_global.h"
+
+#include <QString>
+#include <QStringList>
+#include <QFileInfo>
+
+// Recursively finds files whose names end with the given suffix. Each directory
+// is listed only once and sibling directories are listed in parallel. The order
+// of the result does not depend on scheduling: files of a directory go first,
+// then files of its subdirectories, all sorted by name.
+OMKITSHARED_EXPORT QStringList findFiles(QString rootPath, QString suffix);
+
+// Same as findFiles(), but accepts several suffixes and the returned infos
+// already hold the size and modification time of every file, fetched on the
+// walker threads.
+OMKITSHARED_EXPORT QFileInfoList findFileInfos(QString rootPath, const QStringList& suffixes);
+
+#endif // DIRWALKER_H
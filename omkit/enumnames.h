@@ -0,0 +1,49 @@
+#ifndef ENUMNAMES_H
+#define ENUMNAMES_H
+
+#include <QLatin1String>
+#include <QString>
+#include <cstddef>
+
+template <typename Enum>
+struct EnumName {
+    Enum value;
+    const char* name;
+};
+
+// Table of names for an enum whose values go from 0 without gaps, entries
+// listed in the order of values. It is a constant aggregate, so nothing is
+// built at static initialization and a name is found by indexing.
+template <typename Enum, std::size_t N>
+struct EnumNames {
+    constexpr bool isDense(std::size_t index = 0) const
+    {
+        return index == N
+                || (static_cast<std::size_t>(entries[index].value) == index
+                    && isDense(index + 1));
+    }
+
+    constexpr const char* nameOf(Enum value) const
+    {
+        return static_cast<std::size_t>(value) < N
+                ? entries[static_cast<std::size_t>(value)].name : "";
+    }
+
+    Enum valueOf(const QString& name, Enum defaultValue) const
+    {
+        if (name.isEmpty())
+            return defaultValue;
+        // Tables are a few entries long, so the first letter rejects almost
+        // every candidate without a full comparison.
+        for (std::size_t i = 0; i < N; ++i) {
+            const char* entryName = entries[i].name;
+            if (name.at(0) == QLatin1Char(entryName[0]) && name == QLatin1String(entryName))
+                return entries[i].value;
+        }
+        return defaultValue;
+    }
+
+    EnumName<Enum> entries[N];
+};
+
+#endif // ENUMNAMES_H
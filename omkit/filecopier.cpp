@@ -0,0 +1,177 @@
+#include "filecopier.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QtConcurrent>
+
+#if defined(Q_OS_UNIX)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if defined(Q_OS_LINUX)
+#include <linux/fs.h>
+#include <sys/syscall.h>
+#endif
+
+namespace {
+#if defined(Q_OS_UNIX)
+const size_t BUFFER_SIZE = 1 << 20;
+
+bool writeAll(int fd, const char* data, ssize_t size)
+{
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+bool copyData(int srcFd, int dstFd)
+{
+#if defined(Q_OS_LINUX) && defined(__NR_copy_file_range)
+    // The kernel copies without passing the data through user space and
+    // may share extents or do the copy on the server of a network share
+    bool isFirstChunk = true;
+    for (;;) {
+        ssize_t copied = ::syscall(__NR_copy_file_range, srcFd, nullptr, dstFd, nullptr,
+                                   BUFFER_SIZE, 0);
+        if (copied == 0)
+            return true;
+        if (copied < 0) {
+            if (errno == EINTR)
+                continue;
+            if (!isFirstChunk)
+                return false;
+            // Not supported for this kernel or this pair of file systems
+            break;
+        }
+        isFirstChunk = false;
+    }
+#endif
+
+    QByteArray buffer(BUFFER_SIZE, Qt::Uninitialized);
+    for (;;) {
+        ssize_t size = ::read(srcFd, buffer.data(), buffer.size());
+        if (size == 0)
+            return true;
+        if (size < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (!writeAll(dstFd, buffer.constData(), size))
+            return false;
+    }
+}
+
+CopyMethod copyFileUnix(const QByteArray& srcPath, const QByteArray& dstPath)
+{
+    int srcFd = ::open(srcPath.constData(), O_RDONLY | O_CLOEXEC);
+    if (srcFd < 0)
+        return CopyMethod::Failed;
+    struct stat srcStat;
+    if (::fstat(srcFd, &srcStat) != 0) {
+        ::close(srcFd);
+        return CopyMethod::Failed;
+    }
+    int dstFd = ::open(dstPath.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC,
+                       srcStat.st_mode & 0777);
+    if (dstFd < 0) {
+        ::close(srcFd);
+        return CopyMethod::Failed;
+    }
+
+    CopyMethod method = CopyMethod::Failed;
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    if (::ioctl(dstFd, FICLONE, srcFd) == 0)
+        method = CopyMethod::Cloned;
+#endif
+    if (method == CopyMethod::Failed && copyData(srcFd, dstFd))
+        method = CopyMethod::Copied;
+
+    ::close(srcFd);
+    if (::close(dstFd) != 0)
+        method = CopyMethod::Failed;
+    if (method == CopyMethod::Failed)
+        ::unlink(dstPath.constData());
+    return method;
+}
+#endif
+
+struct TaskRunner {
+    typedef CopyMethod result_type;
+
+    template <typename Task>
+    CopyMethod operator()(const Task& task) const
+    {
+        return copyFile(task.srcPath, task.dstPath);
+    }
+};
+} // namespace
+
+CopyMethod copyFile(QString srcPath, QString dstPath)
+{
+#if defined(Q_OS_UNIX)
+    return copyFileUnix(QFile::encodeName(srcPath), QFile::encodeName(dstPath));
+#else
+    return QFile::copy(srcPath, dstPath) ? CopyMethod::Copied : CopyMethod::Failed;
+#endif
+}
+
+CopyReport::CopyReport()
+    : clonedNum(0)
+    , copiedNum(0)
+{}
+
+FileCopier::FileCopier()
+{}
+
+void FileCopier::add(QString srcPath, QString dstPath)
+{
+    tasks.append(Task{ srcPath, dstPath });
+}
+
+bool FileCopier::addDir(QDir srcDir, QDir dstDir)
+{
+    if (!srcDir.exists() || !dstDir.exists())
+        return false;
+    // Dirs are created right away, so that files can be copied in any order
+    auto entries = srcDir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    foreach (const auto& entry, entries) {
+        auto name = entry.fileName();
+        auto srcFilePath = srcDir.absoluteFilePath(name);
+        auto dstFilePath = dstDir.absoluteFilePath(name);
+        if (entry.isDir()) {
+            dstDir.mkdir(name);
+            if (!addDir(QDir(srcFilePath), QDir(dstFilePath)))
+                return false;
+        } else {
+            add(srcFilePath, dstFilePath);
+        }
+    }
+    return true;
+}
+
+CopyReport FileCopier::run()
+{
+    auto methods = QtConcurrent::blockingMapped<QList<CopyMethod>>(tasks, TaskRunner());
+
+    CopyReport report;
+    for (int i = 0; i < tasks.size(); ++i) {
+        switch (methods[i]) {
+        case CopyMethod::Failed: report.failedPaths.append(tasks[i].srcPath); break;
+        case CopyMethod::Cloned: report.clonedNum++; break;
+        case CopyMethod::Copied: report.copiedNum++; break;
+        }
+    }
+    tasks.clear();
+    return report;
+}
@@ -0,0 +1,51 @@
+#ifndef FILECOPIER_H
+#define FILECOPIER_H
+
+#include "omkit_global.h"
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QDir>
+
+enum class CopyMethod {
+    Failed,
+    Cloned,
+    Copied
+};
+
+// Copies one file, failing if the destination exists. A reflink clone is
+// tried first, then a copy done by the kernel and, at last, a buffered
+// copy. The copy never shares an inode with the source, so either of them
+// may be edited afterwards.
+OMKITSHARED_EXPORT CopyMethod copyFile(QString srcPath, QString dstPath);
+
+struct OMKITSHARED_EXPORT CopyReport {
+    CopyReport();
+
+    bool isSuccessful() const { return failedPaths.isEmpty(); }
+
+    int clonedNum;
+    int copiedNum;
+    QStringList failedPaths;
+};
+
+class OMKITSHARED_EXPORT FileCopier
+{
+public:
+    FileCopier();
+
+    void add(QString srcPath, QString dstPath);
+    bool addDir(QDir srcDir, QDir dstDir);
+    CopyReport run();
+
+private:
+    struct Task {
+        QString srcPath;
+        QString dstPath;
+    };
+
+    QList<Task> tasks;
+};
+
+#endif // FILECOPIER_H
@@ -31,13 +31,18 @@ QList<Group> Group::load(QString path)
 }
 
 bool Group::save(const QList<Group>& groups, QString path)
+{
+    return writeJSON(path, toJson(groups));
+}
+
+QJsonObject Group::toJson(const QList<Group>& groups)
 {
     QJsonObject rootObj;
     QJsonArray groupsJSON;
     for (const auto& group : groups)
         groupsJSON.append(group.toJson());
     rootObj["groups"] = groupsJSON;
-    return writeJSON(path, rootObj);
+    return rootObj;
 }
 
 Group Group::fromJson(const QJsonObject& jsonObject)
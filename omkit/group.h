@@ -16,6 +16,7 @@ public:
     static Group createGroup();
     static QList<Group> load(QString path);
     static bool save(const QList<Group>& groups, QString path);
+    static QJsonObject toJson(const QList<Group>& groups);
 
     static Group fromJson(const QJsonObject& jsonObject);
     QJsonObject toJson() const;
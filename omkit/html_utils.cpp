@@ -7,6 +7,51 @@
 #include <QTextBlockFormat>
 #include <QTextImageFormat>
 #include <QTextEdit>
+#include <QHash>
+#include <QSet>
+
+namespace {
+QChar decodeEntity(const QString& entity)
+{
+    static const QHash<QString, QChar> ENTITIES{
+        { "amp", '&' }, { "lt", '<' }, { "gt", '>' }, { "quot", '"' },
+        { "apos", '\'' }, { "nbsp", ' ' }, { "laquo", QChar(0xAB) },
+        { "raquo", QChar(0xBB) }, { "mdash", QChar(0x2014) }, { "ndash", QChar(0x2013) }
+    };
+    if (entity.startsWith('#')) {
+        bool isOk;
+        uint code = entity.startsWith("#x", Qt::CaseInsensitive)
+                ? entity.mid(2).toUInt(&isOk, 16)
+                : entity.mid(1).toUInt(&isOk);
+        return isOk && code <= 0xFFFF ? QChar(code) : QChar(' ');
+    }
+    return ENTITIES.value(entity, QChar(' '));
+}
+
+// Tags that break the text, as opposed to inline ones such as <b> or <span>
+// that may split a word
+bool isBlockTag(QString tagName)
+{
+    static const QSet<QString> BLOCK_TAGS{
+        "p", "br", "div", "li", "td", "th", "tr", "h1", "h2", "h3", "h4", "h5", "h6"
+    };
+    if (tagName.startsWith('/'))
+        tagName.remove(0, 1);
+    if (tagName.endsWith('/'))
+        tagName.chop(1);
+    return BLOCK_TAGS.contains(tagName);
+}
+
+// Returns the position after the element, e.g. after "</style>"
+int skipElement(const QString& html, int pos, QString tagName)
+{
+    int end = html.indexOf("</" + tagName, pos, Qt::CaseInsensitive);
+    if (end == -1)
+        return html.size();
+    end = html.indexOf('>', end);
+    return end == -1 ? html.size() : end + 1;
+}
+}
 
 QString readHTML(QString fileName)
 {
@@ -22,6 +67,43 @@ QString readHTML(QString fileName)
     return str;
 }
 
+QString htmlToPlainText(QString html)
+{
+    QString result;
+    result.reserve(html.size() / 2);
+    int pos = 0;
+    while (pos < html.size()) {
+        QChar c = html[pos];
+        if (c == '<') {
+            int end = html.indexOf('>', pos);
+            if (end == -1)
+                break;
+            QString tagName = html.mid(pos + 1, end - pos - 1).trimmed()
+                    .section(' ', 0, 0).toLower();
+            if (tagName == "head" || tagName == "style" || tagName == "script") {
+                pos = skipElement(html, end + 1, tagName);
+            } else {
+                pos = end + 1;
+            }
+            if (isBlockTag(tagName))
+                result.append(' ');
+        } else if (c == '&') {
+            int end = html.indexOf(';', pos);
+            if (end == -1 || end - pos > 10) {
+                result.append(c);
+                ++pos;
+            } else {
+                result.append(decodeEntity(html.mid(pos + 1, end - pos - 1)));
+                pos = end + 1;
+            }
+        } else {
+            result.append(c);
+            ++pos;
+        }
+    }
+    return result;
+}
+
 bool writeHTML(QString fileName, QTextDocument* document)
 {
     QTextDocumentWriter writer(fileName);
@@ -70,7 +152,7 @@ void addImage(QDir dir, const CaseImage& image, QTextEdit* textEdit)
         blockFormat.setTopMargin(15);
     cursor.insertBlock(blockFormat);
 
-    QImage imageData(dir.absoluteFilePath(image.fileName));
+    QImage imageData(image.filePath(dir));
     if (image.width != imageData.width() || image.height != imageData.height()) {
         imageData = imageData.scaled(image.width, image.height, Qt::IgnoreAspectRatio,
                                      Qt::SmoothTransformation);
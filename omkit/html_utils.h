@@ -10,6 +10,9 @@ class QTextDocument;
 class QTextEdit;
 
 OMKITSHARED_EXPORT QString readHTML(QString fileName);
+// Drops tags, styles and scripts and decodes entities. Unlike
+// QTextDocument it may be used on any thread.
+OMKITSHARED_EXPORT QString htmlToPlainText(QString html);
 OMKITSHARED_EXPORT bool writeHTML(QString fileName, QTextDocument* document);
 OMKITSHARED_EXPORT void setImageAndHTML(
         QDir dir, const CaseImage& image, QString html, QTextEdit* textEdit);
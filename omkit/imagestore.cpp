@@ -0,0 +1,95 @@
+#include "imagestore.h"
+#include "utils.h"
+#include "filecopier.h"
+#include <QFile>
+#include <QFileInfo>
+
+namespace {
+const QString STORE_DIR_NAME = "omimages";
+
+QString joinPath(QString dirPath, QString name)
+{
+    if (dirPath.isEmpty() || dirPath == ".")
+        return name;
+    return dirPath + "/" + name;
+}
+}
+
+ImageStore::ImageStore(QDir sectionDir)
+    : ImageStore(sectionDir, sectionDir)
+{}
+
+ImageStore::ImageStore(QDir sectionDir, QDir rootDir)
+    : sectionDir(sectionDir)
+    , dir(storePath(rootDir.absolutePath()))
+{}
+
+QString ImageStore::storePath(QString rootPath)
+{
+    return QDir::cleanPath(rootPath + "/" + STORE_DIR_NAME);
+}
+
+QString ImageStore::fileName(const CaseImage& image)
+{
+    QString suffix = QFileInfo(image.fileName).suffix().toLower();
+    return suffix.isEmpty() ? image.hash : image.hash + "." + suffix;
+}
+
+QString ImageStore::archivePath(const CaseImage& image, QString rootArchivePath)
+{
+    return joinPath(joinPath(rootArchivePath, STORE_DIR_NAME), fileName(image));
+}
+
+QString ImageStore::relativeArchivePath(const CaseImage& image, QString rootArchivePath,
+                                        QString sectionArchivePath)
+{
+    // Archive paths are made absolute only to be compared, they do not
+    // refer to any files
+    QDir sectionDir("/" + QFileInfo(sectionArchivePath).path());
+    return sectionDir.relativeFilePath("/" + archivePath(image, rootArchivePath));
+}
+
+QString ImageStore::filePath(const CaseImage& image) const
+{
+    if (image.hash.isEmpty())
+        return QString();
+    return dir.absoluteFilePath(fileName(image));
+}
+
+QString ImageStore::relativePath(const CaseImage& image) const
+{
+    return sectionDir.relativeFilePath(filePath(image));
+}
+
+bool ImageStore::contains(const CaseImage& image) const
+{
+    return !image.hash.isEmpty() && QFileInfo(filePath(image)).isFile();
+}
+
+bool ImageStore::add(QString srcPath, CaseImage& image)
+{
+    if (image.hash.isEmpty()) {
+        image.hash = fileHash(srcPath);
+        if (image.hash.isEmpty())
+            return false;
+    }
+    // The section finds the image by its file name even without the hash
+    image.fileName = relativePath(image);
+    if (contains(image))
+        return true;
+    if (!dir.exists() && !QDir().mkpath(dir.absolutePath()))
+        return false;
+
+    // The image is copied under a temporary name, so that a section saved
+    // at the same time never sees a partially written image.
+    QString dstPath = filePath(image);
+    QString tempPath = dstPath + ".part";
+    QFile::remove(tempPath);
+    if (copyFile(srcPath, tempPath) == CopyMethod::Failed)
+        return false;
+    if (!QFile::rename(tempPath, dstPath)) {
+        QFile::remove(tempPath);
+        return contains(image);
+    }
+    return true;
+}
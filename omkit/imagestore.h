@@ -0,0 +1,39 @@
+#ifndef IMAGESTORE_H
+#define IMAGESTORE_H
+
+#include "omkit_global.h"
+#include "caseimage.h"
+
+#include <QString>
+#include <QDir>
+
+// Images shared by the sections lying under one root dir, e.g. the sections
+// dir of a training or the root of an export archive. Every image is stored
+// once under the hash of its content in a subdir of the root, and sections
+// refer to it by a path relative to their own dir. A section saved without
+// a root keeps the store in its own dir.
+class OMKITSHARED_EXPORT ImageStore
+{
+public:
+    explicit ImageStore(QDir sectionDir);
+    ImageStore(QDir sectionDir, QDir rootDir);
+
+    static QString storePath(QString rootPath);
+    static QString fileName(const CaseImage& image);
+    // Path of the image in an archive built by ZipBuilder, relative to the
+    // dir of the section at sectionArchivePath
+    static QString archivePath(const CaseImage& image, QString rootArchivePath);
+    static QString relativeArchivePath(const CaseImage& image, QString rootArchivePath,
+                                       QString sectionArchivePath);
+
+    QString filePath(const CaseImage& image) const;
+    // Path of the stored image relative to the section dir
+    QString relativePath(const CaseImage& image) const;
+    bool contains(const CaseImage& image) const;
+    bool add(QString srcPath, CaseImage& image);
+
+    QDir sectionDir;
+    QDir dir;
+};
+
+#endif // IMAGESTORE_H
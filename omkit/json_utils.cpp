@@ -11,8 +11,13 @@ bool readJSON(QString fileName, QJsonObject& jsonData)
         return false;
     if (!file.open(QIODevice::ReadOnly))
         return false;
+    return parseJSON(file.readAll(), jsonData);
+}
+
+bool parseJSON(const QByteArray& data, QJsonObject& jsonData)
+{
     QJsonParseError errors;
-    QJsonDocument json = QJsonDocument::fromJson(file.readAll(), &errors);
+    QJsonDocument json = QJsonDocument::fromJson(data, &errors);
     if (errors.error != QJsonParseError::NoError)
         return false;
     if (!json.isObject())
@@ -4,9 +4,11 @@
 #include "omkit_global.h"
 
 #include <QString>
+#include <QByteArray>
 #include <QJsonObject>
 
 OMKITSHARED_EXPORT bool readJSON(QString fileName, QJsonObject& jsonData);
+OMKITSHARED_EXPORT bool parseJSON(const QByteArray& data, QJsonObject& jsonData);
 OMKITSHARED_EXPORT bool writeJSON(QString fileName, const QJsonObject& jsonData);
 
 #endif // JSON_UTILS_H
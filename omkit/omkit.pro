@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -33,7 +33,13 @@ SOURCES += omkit.cpp \
     string_utils.cpp \
     caseimage.cpp \
     group.cpp \
-    username.cpp
+    username.cpp \
+    sectioncatalog.cpp \
+    dirwalker.cpp \
+    imagestore.cpp \
+    filecopier.cpp \
+    solutionmanifest.cpp \
+    completionstats.cpp
 
 HEADERS += omkit.h\
         omkit_global.h \
@@ -49,9 +55,15 @@ HEADERS += omkit.h\
     zip_utils.h \
     string_utils.h \
     caseimage.h \
-    smallbimap.h \
+    enumnames.h \
     group.h \
-    username.h
+    username.h \
+    sectioncatalog.h \
+    dirwalker.h \
+    imagestore.h \
+    filecopier.h \
+    solutionmanifest.h \
+    completionstats.h
 
 unix {
     target.path = /usr/lib
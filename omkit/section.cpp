@@ -1,23 +1,29 @@
 #include "section.h"
 #include "json_utils.h"
 #include "utils.h"
+#include "dirwalker.h"
+#include "imagestore.h"
+#include "filecopier.h"
+#include "zip_utils.h"
+#include <QJsonDocument>
 #include <QFileInfo>
 #include <QJsonArray>
 #include <QDir>
+#include <QtConcurrent>
 
 namespace {
-void findAll(QString path, QList<Section>& dst)
-{
-    QDir dir(path);
-    foreach (const auto& entry, dir.entryList(QStringList("*.oms"), QDir::Files)) {
+struct SectionOpener {
+    typedef Section result_type;
+
+    Section operator()(const QString& path) const
+    {
         Section section;
-        section.path = dir.absoluteFilePath(entry);
-        if (section.open())
-            dst.append(section);
+        section.path = path;
+        if (!section.open())
+            return Section();
+        return section;
     }
-    foreach (const auto& entry, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
-        findAll(dir.absoluteFilePath(entry), dst);
-}
+};
 } // namespace
 
 Section::Section()
@@ -33,10 +39,18 @@ Section Section::createSection(QString path)
 }
 
 QList<Section> Section::findAll(QString path)
+{
+    return openAll(findFiles(path, ".oms"));
+}
+
+QList<Section> Section::openAll(const QStringList& paths)
 {
     QList<Section> result;
-    if (QFileInfo(path).isDir())
-        ::findAll(path, result);
+    auto sections = QtConcurrent::blockingMapped<QList<Section>>(paths, SectionOpener());
+    foreach (const auto& section, sections) {
+        if (section.isValid())
+            result.append(section);
+    }
     return result;
 }
 
@@ -97,6 +111,11 @@ bool Section::open()
 }
 
 bool Section::save() const
+{
+    return writeJSON(path, toJson());
+}
+
+QJsonObject Section::toJson() const
 {
     QJsonObject rootObj;
     rootObj["id"] = id.toString();
@@ -109,46 +128,89 @@ bool Section::save() const
     foreach (const auto& c, cases)
         casesArray.append(c.toJson());
     rootObj["cases"] = casesArray;
-
-    return writeJSON(path, rootObj);
+    return rootObj;
 }
 
-Section Section::saveAs(QString newPath) const
+Section Section::saveAs(QString newPath, QString imageRootPath) const
 {
     Section newSection = *this;
     newSection.path = newPath;
     QDir srcDir = dir();
     QDir dstDir = newSection.dir();
-    foreach (const auto& caseValue, cases) {
-        if (!QFile::copy(srcDir.absoluteFilePath(caseValue.questionFileName),
-                         dstDir.absoluteFilePath(caseValue.questionFileName)))
-            return Section();
-        if (!QFile::copy(srcDir.absoluteFilePath(caseValue.answerFileName),
-                         dstDir.absoluteFilePath(caseValue.answerFileName)))
-            return Section();
+    ImageStore dstStore(dstDir, imageRootPath.isEmpty() ? dstDir : QDir(imageRootPath));
+    FileCopier copier;
+    for (auto& caseValue : newSection.cases) {
+        copier.add(srcDir.absoluteFilePath(caseValue.questionFileName),
+                   dstDir.absoluteFilePath(caseValue.questionFileName));
+        copier.add(srcDir.absoluteFilePath(caseValue.answerFileName),
+                   dstDir.absoluteFilePath(caseValue.answerFileName));
+        // Sections saved under the same root share the store, so an image
+        // used by several of them is written once
         if (!caseValue.questionImage.isEmpty()) {
-            if (!QFile::copy(srcDir.absoluteFilePath(caseValue.questionImage.fileName),
-                             dstDir.absoluteFilePath(caseValue.questionImage.fileName)))
+            auto& image = caseValue.questionImage;
+            if (!dstStore.add(image.filePath(srcDir), image))
                 return Section();
         }
         if (!caseValue.answerImage.isEmpty()) {
-            if (!QFile::copy(srcDir.absoluteFilePath(caseValue.answerImage.fileName),
-                             dstDir.absoluteFilePath(caseValue.answerImage.fileName)))
+            auto& image = caseValue.answerImage;
+            if (!dstStore.add(image.filePath(srcDir), image))
                 return Section();
         }
     }
 
     if (!totalFileName.isEmpty()) {
-        if (!QFile::copy(srcDir.absoluteFilePath(totalFileName),
-                         dstDir.absoluteFilePath(totalFileName)))
-            return Section();
+        copier.add(srcDir.absoluteFilePath(totalFileName),
+                   dstDir.absoluteFilePath(totalFileName));
     }
+    if (!copier.run().isSuccessful())
+        return Section();
 
     if (!newSection.save())
         return Section();
     return newSection;
 }
 
+bool Section::addTo(ZipBuilder& builder, QString archivePath,
+                    QString imageRootArchivePath) const
+{
+    Section newSection = *this;
+    QDir srcDir = dir();
+    QString dirPath = QFileInfo(archivePath).path();
+    auto toArchivePath = [&dirPath](QString fileName) {
+        return dirPath == "." ? fileName : dirPath + "/" + fileName;
+    };
+    QString imageRootPath = imageRootArchivePath.isEmpty() ? dirPath : imageRootArchivePath;
+    // The builder skips paths added before, so an image used by several
+    // sections of the archive is written once
+    auto addImage = [&](CaseImage& image) {
+        if (image.isEmpty())
+            return true;
+        QString srcPath = image.filePath(srcDir);
+        if (image.hash.isEmpty())
+            image.hash = fileHash(srcPath);
+        if (image.hash.isEmpty())
+            return false;
+        image.fileName = ImageStore::relativeArchivePath(image, imageRootPath, archivePath);
+        return builder.addFile(srcPath, ImageStore::archivePath(image, imageRootPath));
+    };
+
+    for (auto& caseValue : newSection.cases) {
+        if (!builder.addFile(srcDir.absoluteFilePath(caseValue.questionFileName),
+                             toArchivePath(caseValue.questionFileName))
+            || !builder.addFile(srcDir.absoluteFilePath(caseValue.answerFileName),
+                                toArchivePath(caseValue.answerFileName))
+            || !addImage(caseValue.questionImage)
+            || !addImage(caseValue.answerImage))
+            return false;
+    }
+    if (!totalFileName.isEmpty()) {
+        if (!builder.addFile(srcDir.absoluteFilePath(totalFileName),
+                             toArchivePath(totalFileName)))
+            return false;
+    }
+    return builder.addData(QJsonDocument(newSection.toJson()).toJson(), archivePath);
+}
+
 QString Section::nextCaseFilePrefix()
 {
     QFileInfo fileInfo(path);
@@ -5,10 +5,13 @@
 #include "case.h"
 
 #include <QString>
+#include <QJsonObject>
 #include <QList>
 #include <QDir>
 #include <QUuid>
 
+class ZipBuilder;
+
 class OMKITSHARED_EXPORT Section
 {
 public:
@@ -16,12 +19,19 @@ public:
 
     static Section createSection(QString path);
     static QList<Section> findAll(QString path);
+    static QList<Section> openAll(const QStringList& paths);
 
     bool isValid() const;
     bool remove();
     bool open();
     bool save() const;
-    Section saveAs(QString newPath) const;
+    QJsonObject toJson() const;
+    // Images go to the store in imageRootPath, shared by all sections saved
+    // under it, or to the store in the section dir if the path is empty.
+    // In an archive "." stands for its root.
+    Section saveAs(QString newPath, QString imageRootPath = QString()) const;
+    bool addTo(ZipBuilder& builder, QString archivePath,
+               QString imageRootArchivePath = QString()) const;
     QString nextCaseFilePrefix();
     QDir dir() const;
     void copyHidden(const Section& section);
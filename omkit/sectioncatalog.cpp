@@ -0,0 +1,201 @@
+#include "sectioncatalog.h"
+#include "dirwalker.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+namespace {
+const quint32 CATALOG_MAGIC = 0x4F4D5349;
+const qint32 CATALOG_VERSION = 2;
+
+void writeImage(QDataStream& stream, const CaseImage& image)
+{
+    stream << image.fileName << image.hash
+           << static_cast<qint32>(image.horAlign)
+           << static_cast<qint32>(image.vertAlign)
+           << static_cast<qint32>(image.width)
+           << static_cast<qint32>(image.height);
+}
+
+CaseImage readImage(QDataStream& stream)
+{
+    CaseImage image;
+    qint32 horAlign, vertAlign, width, height;
+    stream >> image.fileName >> image.hash >> horAlign >> vertAlign >> width >> height;
+    image.horAlign = static_cast<CaseImage::HorAlign>(horAlign);
+    image.vertAlign = static_cast<CaseImage::VertAlign>(vertAlign);
+    image.width = width;
+    image.height = height;
+    return image;
+}
+
+void writeSection(QDataStream& stream, const Section& section)
+{
+    stream << section.id << section.name << section.description
+           << section.totalFileName << static_cast<qint32>(section.nextIndex)
+           << static_cast<qint32>(section.cases.size());
+    foreach (const auto& caseValue, section.cases) {
+        stream << caseValue.id << caseValue.name
+               << caseValue.questionFileName << caseValue.answerFileName;
+        writeImage(stream, caseValue.questionImage);
+        writeImage(stream, caseValue.answerImage);
+    }
+}
+
+Section readSection(QDataStream& stream)
+{
+    Section section;
+    qint32 nextIndex, casesNum;
+    stream >> section.id >> section.name >> section.description
+           >> section.totalFileName >> nextIndex >> casesNum;
+    section.nextIndex = nextIndex;
+    if (stream.status() != QDataStream::Ok || casesNum < 0)
+        return Section();
+    section.cases.reserve(casesNum);
+    for (int i = 0; i < casesNum; ++i) {
+        Case caseValue;
+        stream >> caseValue.id >> caseValue.name
+               >> caseValue.questionFileName >> caseValue.answerFileName;
+        caseValue.questionImage = readImage(stream);
+        caseValue.answerImage = readImage(stream);
+        section.cases.append(caseValue);
+    }
+    return section;
+}
+
+struct FileStamp {
+    qint64 size;
+    qint64 lastModified;
+};
+
+struct StampReader {
+    typedef FileStamp result_type;
+
+    FileStamp operator()(const QString& path) const
+    {
+        QFileInfo fileInfo(path);
+        return FileStamp{ fileInfo.size(), fileInfo.lastModified().toMSecsSinceEpoch() };
+    }
+};
+
+} // namespace
+
+SectionCatalog::SectionCatalog(QString path)
+    : path(path)
+    , hitsNum(0)
+    , missesNum(0)
+{}
+
+bool SectionCatalog::read()
+{
+    entries.clear();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    quint32 magic;
+    qint32 version, entriesNum;
+    stream >> magic >> version >> entriesNum;
+    if (magic != CATALOG_MAGIC || version != CATALOG_VERSION || entriesNum < 0)
+        return false;
+
+    for (int i = 0; i < entriesNum; ++i) {
+        QString sectionPath;
+        Entry entry;
+        stream >> sectionPath >> entry.size >> entry.lastModified;
+        entry.section = readSection(stream);
+        if (stream.status() != QDataStream::Ok) {
+            entries.clear();
+            return false;
+        }
+        entry.section.path = sectionPath;
+        entries[sectionPath] = entry;
+    }
+    return true;
+}
+
+bool SectionCatalog::write() const
+{
+    // A catalog cut off by a crash would be read as empty and rebuilt,
+    // so it is replaced atomically
+    QSaveFile file(path);
+    file.setDirectWriteFallback(true);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+    stream << CATALOG_MAGIC << CATALOG_VERSION << static_cast<qint32>(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        const auto& entry = it.value();
+        stream << it.key() << entry.size << entry.lastModified;
+        writeSection(stream, entry.section);
+    }
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+
+QList<Section> SectionCatalog::findAll(QString sectionsPath, bool forceRebuild)
+{
+    hitsNum = 0;
+    missesNum = 0;
+    QList<Section> result;
+    if (!QFileInfo(sectionsPath).isDir())
+        return result;
+
+    auto paths = findFiles(sectionsPath, ".oms");
+    auto stamps = QtConcurrent::blockingMapped<QList<FileStamp>>(paths, StampReader());
+
+    QStringList changedPaths;
+    for (int i = 0; i < paths.size(); ++i) {
+        auto it = entries.constFind(paths[i]);
+        if (forceRebuild || it == entries.cend()
+            || it->size != stamps[i].size || it->lastModified != stamps[i].lastModified)
+            changedPaths.append(paths[i]);
+    }
+    // Sections that fail to open are left out
+    QHash<QString, Section> changedSections;
+    foreach (const auto& section, Section::openAll(changedPaths))
+        changedSections[section.path] = section;
+
+    QHash<QString, Entry> newEntries;
+    int changedIndex = 0;
+    for (int i = 0; i < paths.size(); ++i) {
+        Entry entry;
+        entry.size = stamps[i].size;
+        entry.lastModified = stamps[i].lastModified;
+        if (changedIndex < changedPaths.size() && changedPaths[changedIndex] == paths[i]) {
+            changedIndex++;
+            missesNum++;
+            if (!changedSections.contains(paths[i]))
+                continue;
+            entry.section = changedSections[paths[i]];
+        } else {
+            entry.section = entries[paths[i]].section;
+            hitsNum++;
+        }
+        newEntries[paths[i]] = entry;
+        result.append(entry.section);
+    }
+    entries.swap(newEntries);
+    return result;
+}
+
+int SectionCatalog::hits() const
+{
+    return hitsNum;
+}
+
+int SectionCatalog::misses() const
+{
+    return missesNum;
+}
@@ -0,0 +1,37 @@
+#ifndef SECTIONCATALOG_H
+#define SECTIONCATALOG_H
+
+#include "omkit_global.h"
+#include "section.h"
+
+#include <QString>
+#include <QList>
+#include <QHash>
+
+class OMKITSHARED_EXPORT SectionCatalog
+{
+public:
+    SectionCatalog(QString path);
+
+    bool read();
+    bool write() const;
+    QList<Section> findAll(QString sectionsPath, bool forceRebuild = false);
+
+    int hits() const;
+    int misses() const;
+
+    QString path;
+
+private:
+    struct Entry {
+        qint64 size;
+        qint64 lastModified;
+        Section section;
+    };
+
+    QHash<QString, Entry> entries;
+    int hitsNum;
+    int missesNum;
+};
+
+#endif // SECTIONCATALOG_H
@@ -2,28 +2,67 @@
 #include "section.h"
 #include "json_utils.h"
 #include "utils.h"
+#include "dirwalker.h"
 #include <QDir>
 #include <QFileInfo>
 #include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
 #include <QSet>
+#include <QtConcurrent>
 
 namespace {
-void findAll(QString path, QList<Solution>& dst)
+// The journal is compacted once it holds more records than the solution has
+// answers, so that rewriting the solution file costs O(1) per saved answer.
+const int MIN_JOURNAL_SIZE = 32;
+
+// The last record may be cut off by a writer that is still appending it,
+// such records give an invalid answer
+Answer parseRecord(const QByteArray& line)
 {
-    QDir dir(path);
-    foreach (const auto& entry, dir.entryList(QStringList("*.omsol"), QDir::Files)) {
-        Solution solution;
-        solution.dirPath = path;
-        solution.fileName = entry;
-        if (solution.open())
-            dst.append(solution);
+    QJsonParseError errors;
+    auto json = QJsonDocument::fromJson(line, &errors);
+    if (errors.error != QJsonParseError::NoError || !json.isObject())
+        return Answer();
+    return Answer::fromJson(json.object());
+}
+
+int parseJournal(const QByteArray& data, QList<Answer>& answers)
+{
+    auto lines = data.split('\n');
+    int linesNum = 0;
+    foreach (const auto& line, lines) {
+        if (line.trimmed().isEmpty())
+            continue;
+        linesNum++;
+        auto answer = parseRecord(line);
+        if (answer.isValid())
+            answers.append(answer);
     }
-    foreach (const auto& entry, dir.entryList(QDir::Dirs | QDir::NoDotAndDotDot))
-        findAll(dir.absoluteFilePath(entry), dst);
+    return linesNum;
 }
+
+struct SolutionOpener {
+    typedef Solution result_type;
+
+    Solution operator()(const QString& path) const
+    {
+        QFileInfo fileInfo(path);
+        Solution solution;
+        solution.dirPath = fileInfo.absolutePath();
+        solution.fileName = fileInfo.fileName();
+        if (!solution.open())
+            return Solution();
+        return solution;
+    }
+};
 } // namespace
 
+const QString Solution::JOURNAL_SUFFIX = ".journal";
+
 Solution::Solution()
+    : finalAnswersCount(0)
+    , journalSize(0)
 {}
 
 Solution Solution::createSolution(const Section& section)
@@ -35,19 +74,58 @@ Solution Solution::createSolution(const Section& section)
 }
 
 QList<Solution> Solution::findAll(QString path)
+{
+    return openAll(findFiles(path, ".omsol"));
+}
+
+QList<Solution> Solution::openAll(const QStringList& paths)
 {
     QList<Solution> result;
-    if (QFileInfo(path).isDir())
-        ::findAll(path, result);
+    auto solutions = QtConcurrent::blockingMapped<QList<Solution>>(paths, SolutionOpener());
+    foreach (const auto& solution, solutions) {
+        if (solution.isValid())
+            result.append(solution);
+    }
     return result;
 }
 
+QString Solution::journalFileName(QString fileName)
+{
+    return fileName + JOURNAL_SUFFIX;
+}
+
 bool Solution::open()
 {
     QDir dir(dirPath);
     QString path = dir.absoluteFilePath(fileName);
+    // The journal is read first: compaction only moves records from the
+    // journal to the solution file, so a concurrent compaction can not hide
+    // an answer from this reader.
+    QFile journalFile(dir.absoluteFilePath(journalFileName(fileName)));
+    QByteArray journalData;
+    if (journalFile.open(QIODevice::ReadOnly))
+        journalData = journalFile.readAll();
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly) || !parse(file.readAll(), journalData))
+        return false;
+    markAsSaved(path);
+    return true;
+}
+
+bool Solution::open(const QByteArray& data, const QByteArray& journalData)
+{
+    if (!parse(data, journalData))
+        return false;
+    markAsSaved(QString());
+    return true;
+}
+
+bool Solution::parse(const QByteArray& data, const QByteArray& journalData)
+{
+    QList<Answer> journalAnswers;
+    int journalLinesNum = parseJournal(journalData, journalAnswers);
     QJsonObject rootObj;
-    if (!readJSON(path, rootObj))
+    if (!parseJSON(data, rootObj))
         return false;
 
     sectionId = QUuid(rootObj["sectionId"].toString(""));
@@ -59,27 +137,161 @@ bool Solution::open()
         return false;
 
     QJsonArray answersArray = rootObj["answers"].toArray();
-    answers.clear();
-    foreach (auto answer, answersArray)
-        answers.append(Answer::fromJson(answer.toObject()));
-
+    answerList.clear();
+    answerIndices.clear();
+    finalAnswersCount = 0;
+    answerList.reserve(answersArray.size());
+    answerIndices.reserve(answersArray.size());
+    foreach (auto answerValue, answersArray) {
+        auto answer = Answer::fromJson(answerValue.toObject());
+        if (indexOfOldAnswer(answer) != -1)
+            setAnswer(answer);
+    }
+    foreach (const auto& answer, journalAnswers) {
+        if (indexOfOldAnswer(answer) != -1)
+            setAnswer(answer);
+    }
+    journalSize = journalLinesNum;
     return true;
 }
 
 bool Solution::save()
 {
+    QString path = dir().absoluteFilePath(fileName);
+    if (path != savedPath || sectionId != savedSectionId || userName != savedUserName)
+        return saveAll();
+
+    QList<Answer> newAnswers;
+    foreach (const auto& answer, answerList) {
+        if (savedVersions.value(answer.caseId, -1) != answer.version)
+            newAnswers.append(answer);
+    }
+    if (newAnswers.isEmpty())
+        return true;
+    if (journalSize + newAnswers.size() > qMax(MIN_JOURNAL_SIZE, answerList.size())
+        || !QFileInfo(path).isFile())
+        return saveAll();
+    return appendToJournal(newAnswers);
+}
+
+bool Solution::saveAll()
+{
+    QDir dir(dirPath);
+    QString path = dir.absoluteFilePath(fileName);
+    QString journalPath = dir.absoluteFilePath(journalFileName(fileName));
+    // Other writers may have appended answers since the files were read,
+    // they must not be lost by the rewrite
+    if (path == savedPath) {
+        Solution saved;
+        saved.dirPath = dirPath;
+        saved.fileName = fileName;
+        if (saved.open() && saved.sectionId == sectionId) {
+            foreach (const auto& answer, saved.answerList) {
+                if (indexOfOldAnswer(answer) != -1)
+                    setAnswer(answer);
+            }
+        }
+    }
+
     QJsonObject rootObj;
     rootObj["sectionId"] = sectionId.toString();
     rootObj["userName"] = userName;
 
     QJsonArray answersArray;
-    foreach (const auto& answer, answers)
+    foreach (const auto& answer, answerList)
         answersArray.append(answer.toJson());
     rootObj["answers"] = answersArray;
 
-    QDir dir(dirPath);
-    QString path = dir.absoluteFilePath(fileName);
-    return writeJSON(path, rootObj);
+    // The solution file is replaced atomically, so readers see either the
+    // old file with the journal or the new one.
+    QSaveFile file(path);
+    file.setDirectWriteFallback(true);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (file.write(QJsonDocument(rootObj).toJson()) == -1 || !file.commit())
+        return false;
+
+    markAsSaved(path);
+    if (!compactJournal(journalPath)) {
+        // Records left in the journal are older than the solution file, so
+        // only the compaction is postponed.
+        journalSize = MIN_JOURNAL_SIZE;
+    }
+    return true;
+}
+
+bool Solution::compactJournal(QString journalPath)
+{
+    QFile journalFile(journalPath);
+    if (!journalFile.exists()) {
+        journalSize = 0;
+        return true;
+    }
+    if (!journalFile.open(QIODevice::ReadOnly))
+        return false;
+    auto data = journalFile.readAll();
+    journalFile.close();
+
+    // Only the records included in the solution file are dropped, the ones
+    // appended after it was written stay in the journal
+    QByteArray restData;
+    int restSize = 0;
+    foreach (const auto& line, data.split('\n')) {
+        auto answer = parseRecord(line);
+        if (!answer.isValid())
+            continue;
+        auto it = answerIndices.constFind(answer.caseId);
+        if (it != answerIndices.cend() && answerList[it.value()].version >= answer.version)
+            continue;
+        restData.append(line);
+        restData.append('\n');
+        restSize++;
+    }
+    if (restData.isEmpty()) {
+        if (!QFile::remove(journalPath))
+            return false;
+    } else {
+        QSaveFile restFile(journalPath);
+        restFile.setDirectWriteFallback(true);
+        if (!restFile.open(QIODevice::WriteOnly) || restFile.write(restData) == -1
+            || !restFile.commit())
+            return false;
+    }
+    journalSize = restSize;
+    return true;
+}
+
+bool Solution::appendToJournal(const QList<Answer>& newAnswers)
+{
+    QFile file(dir().absoluteFilePath(journalFileName(fileName)));
+    if (!file.open(QIODevice::ReadWrite))
+        return false;
+
+    QByteArray data;
+    // A record cut off by a failed write must not swallow the next one
+    if (file.size() > 0 && file.seek(file.size() - 1) && file.read(1) != "\n")
+        data.append('\n');
+    foreach (const auto& answer, newAnswers) {
+        data.append(QJsonDocument(answer.toJson()).toJson(QJsonDocument::Compact));
+        data.append('\n');
+    }
+    if (!file.seek(file.size()) || file.write(data) != data.size() || !file.flush())
+        return false;
+
+    foreach (const auto& answer, newAnswers)
+        savedVersions[answer.caseId] = answer.version;
+    journalSize += newAnswers.size();
+    return true;
+}
+
+void Solution::markAsSaved(QString path)
+{
+    savedPath = path;
+    savedSectionId = sectionId;
+    savedUserName = userName;
+    savedVersions.clear();
+    foreach (const auto& answer, answerList)
+        savedVersions[answer.caseId] = answer.version;
 }
 
 bool Solution::moveTo(QString newDirPath)
@@ -91,11 +303,17 @@ bool Solution::moveTo(QString newDirPath)
     if (!QFile::rename(thisDir.absoluteFilePath(fileName),
                        otherDir.absoluteFilePath(fileName)))
         return false;
-    foreach (const auto& answer, answers) {
+    QString journalPath = thisDir.absoluteFilePath(journalFileName(fileName));
+    if (QFile::exists(journalPath)
+        && !QFile::rename(journalPath, otherDir.absoluteFilePath(journalFileName(fileName))))
+        return false;
+    foreach (const auto& answer, answerList) {
         if (!QFile::rename(thisDir.absoluteFilePath(answer.fileName),
                            otherDir.absoluteFilePath(answer.fileName)))
             return false;
     }
+    if (savedPath == thisDir.absoluteFilePath(fileName))
+        savedPath = otherDir.absoluteFilePath(fileName);
     dirPath = newDirPath;
     return true;
 }
@@ -112,55 +330,76 @@ bool Solution::isValid() const
 
 bool Solution::isEqual(const Solution& other) const
 {
-    if (answers.size() != other.answers.size())
+    if (answerList.size() != other.answerList.size())
         return false;
-    for (int i = 0; i < other.answers.size(); ++i) {
-        const auto& thisAnswer = answers[i];
-        const auto& otherAnswer = other.answers[i];
+    for (int i = 0; i < other.answerList.size(); ++i) {
+        const auto& thisAnswer = answerList[i];
+        const auto& otherAnswer = other.answerList[i];
         if (thisAnswer.caseId != otherAnswer.caseId
             || thisAnswer.version != otherAnswer.version)
             return false;
+        if (!thisAnswer.hash.isEmpty() && !otherAnswer.hash.isEmpty()
+            && thisAnswer.hash != otherAnswer.hash)
+            return false;
     }
     return true;
 }
 
 bool Solution::merge(const Solution& other)
+{
+    return merge(other, copyWithOverwrite);
+}
+
+bool Solution::merge(const Solution& other, const AnswerCopier& copyAnswer)
 {
     auto thisDir = dir();
     auto otherDir = other.dir();
-    foreach (const auto& answer, other.answers) {
+    foreach (const auto& answer, other.answerList) {
         int index = indexOfOldAnswer(answer);
         if (index == -1)
             continue;
-        if (!copyWithOverwrite(otherDir.absoluteFilePath(answer.fileName),
-                               thisDir.absoluteFilePath(answer.fileName)))
+        // A newer version with the same content only updates the solution file
+        bool isSameFile = index < answerList.size()
+                && !answer.hash.isEmpty()
+                && answerList[index].hash == answer.hash
+                && answerList[index].fileName == answer.fileName
+                && thisDir.exists(answer.fileName);
+        if (!isSameFile
+            && !copyAnswer(otherDir.filePath(answer.fileName),
+                           thisDir.absoluteFilePath(answer.fileName)))
             return false;
-        if (index == answers.size()) {
-            answers.append(answer);
-        } else {
-            answers[index] = answer;
-        }
+        setAnswer(answer);
     }
     return save();
 }
 
-Answer& Solution::addAnswer(const Case& caseValue)
+const QList<Answer>& Solution::answers() const
 {
-    for (int i = 0; i < answers.size(); ++i) {
-        auto& answer = answers[i];
-        if (answer.caseId == caseValue.id)
-            return answer;
-    }
-    answers.append(Answer::createAnswer(caseValue));
-    return answers.back();
+    return answerList;
 }
 
 Answer Solution::answer(const Case& caseValue) const
 {
-    foreach (const auto& answer, answers)
-        if (answer.caseId == caseValue.id)
-            return answer;
-    return Answer();
+    auto it = answerIndices.constFind(caseValue.id);
+    if (it == answerIndices.cend())
+        return Answer();
+    return answerList[it.value()];
+}
+
+void Solution::setAnswer(const Answer& newAnswer)
+{
+    auto it = answerIndices.constFind(newAnswer.caseId);
+    if (it == answerIndices.cend()) {
+        answerIndices[newAnswer.caseId] = answerList.size();
+        answerList.append(newAnswer);
+    } else {
+        auto& answer = answerList[it.value()];
+        if (answer.isFinal())
+            finalAnswersCount--;
+        answer = newAnswer;
+    }
+    if (newAnswer.isFinal())
+        finalAnswersCount++;
 }
 
 Solution Solution::cloneHeader(QString newDirPath) const
@@ -175,23 +414,15 @@ Solution Solution::cloneHeader(QString newDirPath) const
 
 int Solution::finalAnswersNum() const
 {
-    int result = 0;
-    foreach (const auto& answer, answers) {
-        if (answer.isFinal())
-            result++;
-    }
-    return result;
+    return finalAnswersCount;
 }
 
 int Solution::indexOfOldAnswer(const Answer& newAnswer) const
 {
-    for (int i = 0; i < answers.size(); ++i) {
-        const auto& answer = answers[i];
-        if (answer.caseId == newAnswer.caseId) {
-            if (answer.version >= newAnswer.version)
-                return -1;
-            return i;
-        }
-    }
-    return answers.size();
+    auto it = answerIndices.constFind(newAnswer.caseId);
+    if (it == answerIndices.cend())
+        return answerList.size();
+    if (answerList[it.value()].version >= newAnswer.version)
+        return -1;
+    return it.value();
 }
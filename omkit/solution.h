@@ -6,28 +6,40 @@
 
 #include <QString>
 #include <QList>
+#include <QHash>
 #include <QUuid>
 #include <QDir>
+#include <functional>
 
 class Section;
 
 class OMKITSHARED_EXPORT Solution
 {
 public:
+    // Copies an answer file of another solution to this one
+    typedef std::function<bool(QString srcPath, QString dstPath)> AnswerCopier;
+
     Solution();
 
     static Solution createSolution(const Section& section);
     static QList<Solution> findAll(QString path);
+    static QList<Solution> openAll(const QStringList& paths);
+    static QString journalFileName(QString fileName);
 
     bool open();
+    // Reads a solution that is not stored in its own file, e.g. one in an
+    // archive. The result is saved as a whole by the next save().
+    bool open(const QByteArray& data, const QByteArray& journalData);
     bool save();
     bool moveTo(QString newDirPath);
     QDir dir() const;
     bool isValid() const;
     bool isEqual(const Solution& other) const;
     bool merge(const Solution& other);
-    Answer& addAnswer(const Case& caseValue);
+    bool merge(const Solution& other, const AnswerCopier& copyAnswer);
+    const QList<Answer>& answers() const;
     Answer answer(const Case& caseValue) const;
+    void setAnswer(const Answer& newAnswer);
     Solution cloneHeader(QString newDirPath) const;
     int finalAnswersNum() const;
 
@@ -35,10 +47,29 @@ public:
     QString fileName;
     QString userName;
     QString dirPath;
-    QList<Answer> answers;
+
+    static const QString JOURNAL_SUFFIX;
 
 private:
     int indexOfOldAnswer(const Answer& newAnswer) const;
+    bool parse(const QByteArray& data, const QByteArray& journalData);
+    bool saveAll();
+    bool compactJournal(QString journalPath);
+    bool appendToJournal(const QList<Answer>& newAnswers);
+    void markAsSaved(QString path);
+
+    QList<Answer> answerList;
+    QHash<QUuid, int> answerIndices;
+    int finalAnswersCount;
+
+    // State of the files on disk after the last open() or save(). Answers
+    // changed since then are appended to the journal instead of rewriting
+    // the whole solution file.
+    QString savedPath;
+    QUuid savedSectionId;
+    QString savedUserName;
+    QHash<QUuid, int> savedVersions;
+    int journalSize;
 };
 
 #endif // SOLUTION_H
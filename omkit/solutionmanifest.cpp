@@ -0,0 +1,144 @@
+#include "solutionmanifest.h"
+#include "json_utils.h"
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace {
+const QString FILE_NAME = "manifest.json";
+const QString MARKER_SUFFIX = ".json";
+
+// Readers on other machines must never see a half-written file
+bool saveJSON(QString fileName, const QJsonObject& jsonData)
+{
+    QSaveFile file(fileName);
+    // Some shares do not allow renames; the generation check still catches
+    // a torn write then
+    file.setDirectWriteFallback(true);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    if (file.write(QJsonDocument(jsonData).toJson(QJsonDocument::Compact)) == -1)
+        return false;
+    return file.commit();
+}
+
+qint64 readGeneration(const QJsonObject& jsonObject)
+{
+    return jsonObject["generation"].toString("0").toLongLong();
+}
+
+QJsonObject versionsToJson(const QHash<QUuid, int>& versions)
+{
+    QJsonObject result;
+    for (auto it = versions.cbegin(); it != versions.cend(); ++it)
+        result[it.key().toString()] = it.value();
+    return result;
+}
+
+QHash<QUuid, int> versionsFromJson(const QJsonObject& jsonObject)
+{
+    QHash<QUuid, int> result;
+    for (auto it = jsonObject.constBegin(); it != jsonObject.constEnd(); ++it)
+        result[QUuid(it.key())] = it.value().toInt();
+    return result;
+}
+} // namespace
+
+const QString SolutionManifest::DIR_NAME = "_manifests";
+
+SolutionManifest::SolutionManifest()
+    : generation(0)
+{}
+
+QString SolutionManifest::markerPath(QString rootPath, QString userName)
+{
+    return QDir(rootPath).absoluteFilePath(DIR_NAME + "/" + userName + MARKER_SUFFIX);
+}
+
+QString SolutionManifest::filePath(QString rootPath, QString userName)
+{
+    return QDir(rootPath).absoluteFilePath(userName + "/" + FILE_NAME);
+}
+
+SolutionManifest::Entry SolutionManifest::entryOf(const Solution& solution,
+                                                  const QDir& userDir)
+{
+    Entry entry;
+    entry.sectionId = solution.sectionId;
+    entry.filePath = userDir.relativeFilePath(solution.dir().absoluteFilePath(solution.fileName));
+    foreach (const auto& answer, solution.answers())
+        entry.versions[answer.caseId] = answer.version;
+    return entry;
+}
+
+bool SolutionManifest::invalidate(QString rootPath, QString userName)
+{
+    QString path = markerPath(rootPath, userName);
+    return !QFileInfo(path).exists() || QFile::remove(path);
+}
+
+bool SolutionManifest::read(QString rootPath, QString userName)
+{
+    entries.clear();
+    QJsonObject markerObj;
+    QJsonObject manifestObj;
+    if (!readJSON(markerPath(rootPath, userName), markerObj))
+        return false;
+    if (!readJSON(filePath(rootPath, userName), manifestObj))
+        return false;
+    // The manifest may be rewritten after the marker was read, so both must
+    // belong to the same write
+    generation = readGeneration(markerObj);
+    if (generation == 0 || readGeneration(manifestObj) != generation)
+        return false;
+    if (manifestObj["userName"].toString() != userName)
+        return false;
+
+    this->userName = userName;
+    foreach (const auto& value, manifestObj["solutions"].toArray()) {
+        auto entryObj = value.toObject();
+        Entry entry;
+        entry.sectionId = QUuid(entryObj["sectionId"].toString());
+        entry.filePath = entryObj["path"].toString();
+        entry.versions = versionsFromJson(entryObj["versions"].toObject());
+        if (entry.sectionId.isNull() || entry.filePath.isEmpty()) {
+            entries.clear();
+            return false;
+        }
+        entries.append(entry);
+    }
+    return true;
+}
+
+bool SolutionManifest::write(QString rootPath)
+{
+    QDir rootDir(rootPath);
+    if (!rootDir.exists(DIR_NAME) && !rootDir.mkdir(DIR_NAME) && !rootDir.exists(DIR_NAME))
+        return false;
+
+    // Generations only have to differ between writes, so two machines of
+    // the same user do not need to agree on a counter
+    generation = qMax(generation + 1, QDateTime::currentMSecsSinceEpoch());
+    QJsonArray solutionsArray;
+    foreach (const auto& entry, entries) {
+        QJsonObject entryObj;
+        entryObj["sectionId"] = entry.sectionId.toString();
+        entryObj["path"] = entry.filePath;
+        entryObj["versions"] = versionsToJson(entry.versions);
+        solutionsArray.append(entryObj);
+    }
+    // JSON numbers are doubles, so the generation is kept as a string
+    QJsonObject manifestObj;
+    manifestObj["userName"] = userName;
+    manifestObj["generation"] = QString::number(generation);
+    manifestObj["solutions"] = solutionsArray;
+    if (!saveJSON(filePath(rootPath, userName), manifestObj))
+        return false;
+
+    QJsonObject markerObj;
+    markerObj["generation"] = QString::number(generation);
+    return saveJSON(markerPath(rootPath, userName), markerObj);
+}
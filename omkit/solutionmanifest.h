@@ -0,0 +1,47 @@
+#ifndef SOLUTIONMANIFEST_H
+#define SOLUTIONMANIFEST_H
+
+#include "omkit_global.h"
+#include "solution.h"
+
+#include <QString>
+#include <QList>
+#include <QHash>
+#include <QUuid>
+#include <QDir>
+
+// Summary of the solutions of one user on the remote share, kept up to date
+// by the training app, so that control need not list the user dir. Every
+// write bumps the generation and stores it in a small marker file; markers
+// of all users lie in one dir, so a single listing tells which users have
+// changed. A user without a valid marker has to be walked as before.
+class OMKITSHARED_EXPORT SolutionManifest
+{
+public:
+    struct Entry {
+        QUuid sectionId;
+        // Path of the solution file relative to the user dir
+        QString filePath;
+        QHash<QUuid, int> versions;
+    };
+
+    SolutionManifest();
+
+    static const QString DIR_NAME;
+
+    static QString markerPath(QString rootPath, QString userName);
+    static QString filePath(QString rootPath, QString userName);
+    static Entry entryOf(const Solution& solution, const QDir& userDir);
+    // Makes readers fall back to the walk until the owner rewrites the
+    // manifest. Used by those who change the user dir behind the owner.
+    static bool invalidate(QString rootPath, QString userName);
+
+    bool read(QString rootPath, QString userName);
+    bool write(QString rootPath);
+
+    QString userName;
+    qint64 generation;
+    QList<Entry> entries;
+};
+
+#endif // SOLUTIONMANIFEST_H
@@ -1,13 +1,16 @@
 #include "trainingsettings.h"
 #include "json_utils.h"
-#include "smallbimap.h"
+#include "enumnames.h"
 #include <QDir>
 #include <QJsonArray>
 
 namespace {
-const SmallBimap<LoginType, QString> LOGIN_TYPE_NAMES(
-        { LoginType::Login, LoginType::FirstNameAndSurname, LoginType::OnlyFromGroup },
-        { "Login", "FirstNameAndSurname", "OnlyFromGroup" });
+constexpr EnumNames<LoginType, 3> LOGIN_TYPE_NAMES = {{
+    { LoginType::Login, "Login" },
+    { LoginType::FirstNameAndSurname, "FirstNameAndSurname" },
+    { LoginType::OnlyFromGroup, "OnlyFromGroup" }
+}};
+static_assert(LOGIN_TYPE_NAMES.isDense(), "LOGIN_TYPE_NAMES must follow LoginType values");
 } // namespace
 
 TrainingSettings::TrainingSettings(QString path)
@@ -30,7 +33,7 @@ bool TrainingSettings::read()
     hasRemoteSolutionsDir =
             !solutionsPath.isEmpty() && QFileInfo(solutionsPath).isDir();
     groupsPath = rootObj["groupsPath"].toString(groupsPath);
-    loginType = LOGIN_TYPE_NAMES.valueBySecondOr(
+    loginType = LOGIN_TYPE_NAMES.valueOf(
                 rootObj["loginType"].toString(), LoginType::FirstNameAndSurname);
     areAllGroupsAllowed = rootObj["areAllGroupsAllowed"].toBool(areAllGroupsAllowed);
 
@@ -46,6 +49,11 @@ bool TrainingSettings::read()
 }
 
 bool TrainingSettings::write() const
+{
+    return writeJSON(path, toJson());
+}
+
+QJsonObject TrainingSettings::toJson() const
 {
     QJsonObject rootObj;
     rootObj["lastLogin"] = lastLogin;
@@ -55,14 +63,13 @@ bool TrainingSettings::write() const
     rootObj["solutionsPath"] = solutionsPath;
     rootObj["groupsPath"] = groupsPath;
     rootObj["areAllGroupsAllowed"] = areAllGroupsAllowed;
-    rootObj["loginType"] = LOGIN_TYPE_NAMES.valueByFirst(loginType);
+    rootObj["loginType"] = QLatin1String(LOGIN_TYPE_NAMES.nameOf(loginType));
 
     QJsonArray customGroupsJSON;
     for (const auto& id : customGroups)
         customGroupsJSON.append(id.toString());
     rootObj["customGroups"] = customGroupsJSON;
-
-    return writeJSON(path, rootObj);
+    return rootObj;
 }
 
 QString TrainingSettings::localDataPath() const
@@ -83,6 +90,15 @@ QString TrainingSettings::localGroupsPath() const
     return dir.absoluteFilePath("Groups.json");
 }
 
+QString TrainingSettings::localSectionCatalogPath() const
+{
+    QString path = localDataPath();
+    if (path.isEmpty())
+        return QString();
+    QDir dir(path);
+    return dir.absoluteFilePath("Sections.omsidx");
+}
+
 TrainingAnswerType TrainingSettings::answerType() const
 {
     return hasRemoteSolutionsDir
@@ -3,6 +3,7 @@
 
 #include "omkit_global.h"
 #include <QString>
+#include <QJsonObject>
 #include <QUuid>
 #include <QList>
 
@@ -24,8 +25,10 @@ public:
 
     bool read();
     bool write() const;
+    QJsonObject toJson() const;
     QString localDataPath() const;
     QString localGroupsPath() const;
+    QString localSectionCatalogPath() const;
     TrainingAnswerType answerType() const;
 
     QString path;
@@ -1,5 +1,7 @@
 #include "utils.h"
+#include "filecopier.h"
 
+#include <QCryptographicHash>
 #include <QFile>
 #include <QDir>
 #include <QFileInfo>
@@ -75,23 +77,10 @@ bool copyDir(QString srcPath, QString dstPath)
 
 bool copyDir(QDir srcDir, QDir dstDir)
 {
-    if (!srcDir.exists() || !dstDir.exists())
+    FileCopier copier;
+    if (!copier.addDir(srcDir, dstDir))
         return false;
-    auto entries = srcDir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
-    foreach (const auto& entry, entries) {
-        auto name = entry.fileName();
-        auto srcFilePath = srcDir.absoluteFilePath(name);
-        auto dstFilePath = dstDir.absoluteFilePath(name);
-        if (entry.isDir()) {
-            dstDir.mkdir(name);
-            if (!copyDir(srcFilePath, dstFilePath))
-                return false;
-        } else {
-            if (!QFile::copy(srcFilePath, dstFilePath))
-                return false;
-        }
-    }
-    return true;
+    return copier.run().isSuccessful();
 }
 
 bool copyWithOverwrite(QString srcPath, QString dstPath)
@@ -102,3 +91,14 @@ bool copyWithOverwrite(QString srcPath, QString dstPath)
     }
     return QFile::copy(srcPath, dstPath);
 }
+
+QString fileHash(QString path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return QString();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    if (!hash.addData(&file))
+        return QString();
+    return QString::fromLatin1(hash.result().toHex());
+}
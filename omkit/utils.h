@@ -18,4 +18,6 @@ OMKITSHARED_EXPORT bool copyDir(QDir srcDir, QDir dstDir);
 
 OMKITSHARED_EXPORT bool copyWithOverwrite(QString srcPath, QString dstPath);
 
+OMKITSHARED_EXPORT QString fileHash(QString path);
+
 #endif // UTILS_H
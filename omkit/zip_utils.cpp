@@ -1,12 +1,688 @@
 #include "zip_utils.h"
-#include <JlCompress.h>
+#include <quazip.h>
+#include <quazipfile.h>
+#include <unzip.h>
+#include <zlib.h>
+#include <QBuffer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <QVector>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <limits>
 
-bool compress(QString srcDirPath, QString dstPath)
+namespace {
+const qint64 BLOCK_SIZE = 64 * 1024;
+// Leaves room for headers and incompressible data in the 4 GB limit
+const qint64 MAX_ZIP32_SIZE = 0xF0000000LL;
+const int MAX_ZIP32_ENTRIES = 0xFFFF;
+// Input deflated at once: files smaller than a chunk, read whole
+const qint64 MAX_BATCH_SIZE = 32 * 1024 * 1024;
+const qint64 CHUNK_SIZE = 1024 * 1024;
+// Chunks of a large file are primed with the end of the previous chunk,
+// so splitting costs almost nothing in compression ratio
+const int DICTIONARY_SIZE = 32 * 1024;
+// Content is stored when deflating its first block saves less than 5 %
+const int PROBE_SIZE = 64 * 1024;
+const int MIN_PROBE_SIZE = 4 * 1024;
+const double MIN_DEFLATE_GAIN = 0.05;
+const char* const COMPRESSED_SUFFIXES[] = {
+    "png", "jpg", "jpeg", "gif", "webp", "zip", "gz", "bz2", "xz", "7z", "rar",
+    "mp3", "mp4", "avi", "mkv", "docx", "xlsx", "pptx", "odt", "ods"
+};
+const char* const COMPRESSED_MAGICS[] = {
+    "\x89PNG", "\xFF\xD8\xFF", "GIF8", "PK\x03\x04", "\x1F\x8B", "7z\xBC\xAF", "Rar!"
+};
+
+QString joinPath(QString dirPath, QString name)
+{
+    if (dirPath.isEmpty() || dirPath == ".")
+        return name;
+    return dirPath + "/" + name;
+}
+
+QuaZipNewInfo makeInfo(QString archivePath, QString srcPath)
+{
+    return srcPath.isEmpty() ? QuaZipNewInfo(archivePath) : QuaZipNewInfo(archivePath, srcPath);
+}
+
+// Writes a dir entry or streams a file without compressing it
+bool writeStored(QuaZip& zip, QString archivePath, QString srcPath)
+{
+    QuaZipFile zipFile(&zip);
+    if (!zipFile.open(QIODevice::WriteOnly, makeInfo(archivePath, srcPath), nullptr, 0, 0))
+        return false;
+
+    if (!archivePath.endsWith('/')) {
+        QFile file(srcPath);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+        QByteArray buffer;
+        while (!(buffer = file.read(BLOCK_SIZE)).isEmpty()) {
+            if (zipFile.write(buffer) != buffer.size())
+                return false;
+        }
+        if (file.error() != QFile::NoError)
+            return false;
+    }
+    zipFile.close();
+    return zipFile.getZipError() == ZIP_OK;
+}
+
+struct Deflated {
+    Deflated() : isValid(false), isStored(false), crc(0), size(0) {}
+
+    bool isValid;
+    bool isStored;
+    QByteArray data;
+    quint32 crc;
+    qint64 size;
+};
+
+// Produces a raw deflate stream. All chunks but the last one end with a
+// sync flush, so the streams of consecutive chunks can be concatenated.
+bool deflateRaw(const QByteArray& data, int level, const QByteArray& dictionary,
+                bool isLast, QByteArray& result)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return false;
+    if (!dictionary.isEmpty()
+        && deflateSetDictionary(&stream, reinterpret_cast<const Bytef*>(dictionary.constData()),
+                                dictionary.size()) != Z_OK) {
+        deflateEnd(&stream);
+        return false;
+    }
+
+    int flush = isLast ? Z_FINISH : Z_SYNC_FLUSH;
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.constData()));
+    stream.avail_in = data.size();
+    result.resize(deflateBound(&stream, data.size()) + 16);
+    int written = 0;
+    for (;;) {
+        if (written == result.size())
+            result.resize(result.size() * 2);
+        stream.next_out = reinterpret_cast<Bytef*>(result.data()) + written;
+        stream.avail_out = result.size() - written;
+        int status = deflate(&stream, flush);
+        written = result.size() - stream.avail_out;
+        if (status == Z_STREAM_ERROR || (status == Z_BUF_ERROR && stream.avail_out != 0)) {
+            deflateEnd(&stream);
+            return false;
+        }
+        bool isDone = isLast ? status == Z_STREAM_END
+                             : stream.avail_in == 0 && stream.avail_out != 0;
+        if (isDone)
+            break;
+    }
+    deflateEnd(&stream);
+    result.resize(written);
+    return true;
+}
+
+bool hasCompressedSuffix(QString archivePath)
+{
+    QString suffix = QFileInfo(archivePath).suffix().toLower();
+    for (auto compressedSuffix : COMPRESSED_SUFFIXES) {
+        if (suffix == QLatin1String(compressedSuffix))
+            return true;
+    }
+    return false;
+}
+
+bool isCompressed(const QByteArray& head)
+{
+    for (auto magic : COMPRESSED_MAGICS) {
+        if (head.startsWith(magic))
+            return true;
+    }
+    if (head.size() < MIN_PROBE_SIZE)
+        return false;
+    QByteArray probe;
+    if (!deflateRaw(head, 1, QByteArray(), true, probe))
+        return false;
+    return probe.size() > head.size() * (1 - MIN_DEFLATE_GAIN);
+}
+
+Deflated deflateEntry(QString archivePath, QString srcPath, QByteArray data, int level)
+{
+    Deflated result;
+    if (!srcPath.isEmpty()) {
+        QFile file(srcPath);
+        if (!file.open(QIODevice::ReadOnly))
+            return result;
+        data = file.readAll();
+        if (file.error() != QFile::NoError)
+            return result;
+    }
+    result.size = data.size();
+    result.crc = crc32(0, reinterpret_cast<const Bytef*>(data.constData()), data.size());
+    if (hasCompressedSuffix(archivePath) || isCompressed(data.left(PROBE_SIZE))) {
+        result.isStored = true;
+        result.isValid = true;
+        result.data = data;
+        return result;
+    }
+    result.isValid = deflateRaw(data, level, QByteArray(), true, result.data);
+    return result;
+}
+
+bool writeRaw(QuaZip& zip, QString archivePath, QString srcPath, const Deflated& deflated,
+              int level)
+{
+    QuaZipFile zipFile(&zip);
+    auto info = makeInfo(archivePath, srcPath);
+    info.uncompressedSize = deflated.size;
+    if (!zipFile.open(QIODevice::WriteOnly, info, nullptr, deflated.crc,
+                      deflated.isStored ? 0 : Z_DEFLATED, level, true))
+        return false;
+    if (zipFile.write(deflated.data) != deflated.data.size())
+        return false;
+    zipFile.close();
+    return zipFile.getZipError() == ZIP_OK;
+}
+
+class Task : public QRunnable
+{
+public:
+    explicit Task(std::function<void()> function) : function(function) {}
+    void run() override { function(); }
+
+private:
+    std::function<void()> function;
+};
+
+// A pool of one thread runs the tasks on the calling thread instead
+void runAll(QThreadPool& pool, int tasksNum, std::function<void(int)> function)
+{
+    if (pool.maxThreadCount() <= 1) {
+        for (int i = 0; i < tasksNum; ++i)
+            function(i);
+        return;
+    }
+    for (int i = 0; i < tasksNum; ++i)
+        pool.start(new Task([function, i]() { function(i); }));
+    pool.waitForDone();
+}
+
+// Workers read the mapped archive through their own buffers, so they do
+// not share a file position. Archives too large for a QByteArray are
+// opened by every worker instead and the result is null.
+QByteArray mapArchive(QFile& file)
+{
+    if (file.size() > std::numeric_limits<int>::max())
+        return QByteArray();
+    auto data = file.map(0, file.size());
+    return data ? QByteArray::fromRawData(reinterpret_cast<const char*>(data), file.size())
+                : file.readAll();
+}
+
+bool openArchive(QuaZip& zip, QBuffer& buffer, QString srcPath, const QByteArray& archive)
+{
+    if (archive.isNull()) {
+        zip.setZipName(srcPath);
+    } else {
+        buffer.setData(archive);
+        zip.setIoDevice(&buffer);
+    }
+    return zip.open(QuaZip::mdUnzip);
+}
+
+struct ExtractedEntry {
+    QString dstPath;
+    unz64_file_pos position;
+    qint64 size;
+};
+
+// Entries inflated by one worker, which opens its own reader of the archive
+struct ExtractGroup {
+    ExtractGroup() : size(0) {}
+
+    QList<ExtractedEntry> entries;
+    qint64 size;
+};
+
+// QuaZipFile opens only the current file of QuaZip, and QuaZip does not
+// know of a raw minizip seek until some file has been selected through it
+bool goToEntry(QuaZip& zip, unz64_file_pos position)
+{
+    if (!zip.hasCurrentFile() && !zip.goToFirstFile())
+        return false;
+    return unzGoToFilePos64(zip.getUnzFile(), &position) == UNZ_OK;
+}
+
+bool extractEntry(QuaZip& zip, const ExtractedEntry& entry)
+{
+    if (!goToEntry(zip, entry.position))
+        return false;
+    QuaZipFile zipFile(&zip);
+    if (!zipFile.open(QIODevice::ReadOnly))
+        return false;
+
+    QFile file(entry.dstPath);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    // Reserving the whole file at once keeps it from growing in small steps
+    if (entry.size > 0 && !file.resize(entry.size))
+        return false;
+    QByteArray buffer(BLOCK_SIZE, Qt::Uninitialized);
+    qint64 readSize;
+    while ((readSize = zipFile.read(buffer.data(), buffer.size())) > 0) {
+        if (file.write(buffer.constData(), readSize) != readSize)
+            return false;
+    }
+    if (readSize < 0)
+        return false;
+    zipFile.close();
+    // Closing checks the CRC of the inflated data
+    return zipFile.getZipError() == UNZ_OK && file.size() == entry.size;
+}
+
+bool extractGroup(QString srcPath, const QByteArray& archive, const ExtractGroup& group)
+{
+    QBuffer buffer;
+    QuaZip zip;
+    if (!openArchive(zip, buffer, srcPath, archive))
+        return false;
+    foreach (const auto& entry, group.entries) {
+        if (!extractEntry(zip, entry))
+            return false;
+    }
+    zip.close();
+    return true;
+}
+} // namespace
+
+ZipBuilder::ZipBuilder()
+    : isZip64Enabled(false)
+    , threadCount(0)
+    , compressionLevel(Z_DEFAULT_COMPRESSION)
+    , totalSize(0)
+{}
+
+bool ZipBuilder::contains(QString archivePath) const
+{
+    return archivePaths.contains(archivePath) || dirPaths.contains(archivePath);
+}
+
+QString ZipBuilder::newDirPath(QString parentPath, QString dirNamePrefix)
+{
+    QString dirPath = joinPath(parentPath, dirNamePrefix);
+    for (int i = 0; contains(dirPath) && i < 100; ++i)
+        dirPath = joinPath(parentPath, QString("%1_%2").arg(dirNamePrefix).arg(i));
+    if (contains(dirPath))
+        return QString();
+    dirPaths.insert(dirPath);
+    return dirPath;
+}
+
+bool ZipBuilder::addFile(QString srcPath, QString archivePath)
+{
+    QFileInfo fileInfo(srcPath);
+    if (!fileInfo.isFile())
+        return false;
+    return addEntry(Entry{ archivePath, fileInfo.absoluteFilePath(), QByteArray(),
+                           fileInfo.size() });
+}
+
+bool ZipBuilder::addData(const QByteArray& data, QString archivePath)
+{
+    return addEntry(Entry{ archivePath, QString(), data, data.size() });
+}
+
+bool ZipBuilder::addDir(QString srcDirPath, QString archivePath)
+{
+    QDir srcDir(srcDirPath);
+    if (!srcDir.exists())
+        return false;
+    auto entries = srcDir.entryInfoList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot);
+    if (entries.isEmpty() && !archivePath.isEmpty())
+        return addEntry(Entry{ archivePath + "/", srcDir.absolutePath(), QByteArray(), 0 });
+    foreach (const auto& entry, entries) {
+        QString entryArchivePath = joinPath(archivePath, entry.fileName());
+        bool isAdded = entry.isDir()
+                ? addDir(entry.absoluteFilePath(), entryArchivePath)
+                : addFile(entry.absoluteFilePath(), entryArchivePath);
+        if (!isAdded)
+            return false;
+    }
+    return true;
+}
+
+bool ZipBuilder::write(QString dstPath)
+{
+    QuaZip zip(dstPath);
+    zip.setZip64Enabled(isZip64Enabled || needsZip64());
+    if (!zip.open(QuaZip::mdCreate)) {
+        QFile::remove(dstPath);
+        return false;
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threadCount > 0 ? threadCount : QThread::idealThreadCount());
+    auto isLarge = [](const Entry& entry) {
+        return !entry.srcPath.isEmpty() && entry.size > CHUNK_SIZE;
+    };
+    bool isWritten = true;
+    for (int i = 0; isWritten && i < entries.size();) {
+        const auto& entry = entries[i];
+        if (entry.archivePath.endsWith('/')) {
+            isWritten = writeStored(zip, entry.archivePath, entry.srcPath);
+            ++i;
+            continue;
+        }
+        if (isLarge(entry)) {
+            isWritten = writeLarge(zip, entry, pool);
+            ++i;
+            continue;
+        }
+
+        int end = i;
+        qint64 batchSize = 0;
+        while (end < entries.size() && batchSize < MAX_BATCH_SIZE) {
+            const auto& batchEntry = entries[end];
+            if (batchEntry.archivePath.endsWith('/') || isLarge(batchEntry))
+                break;
+            batchSize += batchEntry.size;
+            ++end;
+        }
+        isWritten = writeBatch(zip, i, end, pool);
+        i = end;
+    }
+
+    zip.close();
+    if (!isWritten || zip.getZipError() != ZIP_OK) {
+        QFile::remove(dstPath);
+        return false;
+    }
+    return true;
+}
+
+bool ZipBuilder::addEntry(const Entry& entry)
+{
+    if (contains(entry.archivePath))
+        return true;
+    archivePaths.insert(entry.archivePath);
+    QString dirPath = QFileInfo(entry.archivePath).path();
+    while (!dirPath.isEmpty() && dirPath != "." && !dirPaths.contains(dirPath)) {
+        dirPaths.insert(dirPath);
+        dirPath = QFileInfo(dirPath).path();
+    }
+    entries.append(entry);
+    totalSize += entry.size;
+    return true;
+}
+
+bool ZipBuilder::needsZip64() const
+{
+    return totalSize >= MAX_ZIP32_SIZE || entries.size() >= MAX_ZIP32_ENTRIES;
+}
+
+bool ZipBuilder::writeBatch(QuaZip& zip, int begin, int end, QThreadPool& pool) const
+{
+    QVector<Deflated> results(end - begin);
+    int level = compressionLevel;
+    runAll(pool, end - begin, [this, &results, begin, level](int i) {
+        const auto& entry = entries[begin + i];
+        results[i] = deflateEntry(entry.archivePath, entry.srcPath, entry.data, level);
+    });
+
+    for (int i = begin; i < end; ++i) {
+        const auto& result = results[i - begin];
+        if (!result.isValid
+            || !writeRaw(zip, entries[i].archivePath, entries[i].srcPath, result, level))
+            return false;
+    }
+    return true;
+}
+
+bool ZipBuilder::writeLarge(QuaZip& zip, const Entry& entry, QThreadPool& pool) const
+{
+    bool isStored = hasCompressedSuffix(entry.archivePath);
+    if (!isStored) {
+        QFile file(entry.srcPath);
+        if (!file.open(QIODevice::ReadOnly))
+            return false;
+        isStored = isCompressed(file.read(PROBE_SIZE));
+    }
+    if (!isStored)
+        return writeChunked(zip, entry, pool);
+
+    return writeStored(zip, entry.archivePath, entry.srcPath);
+}
+
+bool ZipBuilder::writeChunked(QuaZip& zip, const Entry& entry, QThreadPool& pool) const
 {
-    return JlCompress::compressDir(dstPath, srcDirPath, true);
+    // The checksum has to be known when the entry is opened in raw mode
+    QFile file(entry.srcPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    Deflated deflated;
+    deflated.crc = crc32(0, nullptr, 0);
+    QByteArray buffer;
+    while (!(buffer = file.read(CHUNK_SIZE)).isEmpty()) {
+        deflated.crc = crc32(deflated.crc, reinterpret_cast<const Bytef*>(buffer.constData()),
+                             buffer.size());
+        deflated.size += buffer.size();
+    }
+    if (file.error() != QFile::NoError || !file.seek(0))
+        return false;
+
+    QuaZipFile zipFile(&zip);
+    auto info = makeInfo(entry.archivePath, entry.srcPath);
+    info.uncompressedSize = deflated.size;
+    if (!zipFile.open(QIODevice::WriteOnly, info, nullptr, deflated.crc,
+                      Z_DEFLATED, compressionLevel, true))
+        return false;
+
+    // A window of chunks is deflated at once, so memory use does not depend
+    // on the file size
+    int windowSize = pool.maxThreadCount() * 2;
+    qint64 readSize = 0;
+    QByteArray dictionary;
+    while (readSize < deflated.size) {
+        QVector<QByteArray> chunks;
+        QVector<QByteArray> dictionaries;
+        while (chunks.size() < windowSize && readSize < deflated.size) {
+            QByteArray chunk = file.read(CHUNK_SIZE);
+            if (chunk.isEmpty())
+                return false;
+            readSize += chunk.size();
+            dictionaries.append(dictionary);
+            dictionary = chunk.right(DICTIONARY_SIZE);
+            chunks.append(chunk);
+        }
+
+        QVector<QByteArray> results(chunks.size());
+        QVector<char> areValid(chunks.size(), false);
+        bool isLastWindow = readSize >= deflated.size;
+        int level = compressionLevel;
+        runAll(pool, chunks.size(), [&, level, isLastWindow](int i) {
+            bool isLast = isLastWindow && i == chunks.size() - 1;
+            areValid[i] = deflateRaw(chunks[i], level, dictionaries[i], isLast, results[i]);
+        });
+        for (int i = 0; i < results.size(); ++i) {
+            if (!areValid[i] || zipFile.write(results[i]) != results[i].size())
+                return false;
+        }
+    }
+    zipFile.close();
+    return zipFile.getZipError() == ZIP_OK;
+}
+
+bool compress(QString srcDirPath, QString dstPath, int threadCount, int compressionLevel)
+{
+    ZipBuilder builder;
+    builder.threadCount = threadCount;
+    builder.compressionLevel = compressionLevel;
+    if (!builder.addDir(srcDirPath, ""))
+        return false;
+    return builder.write(dstPath);
 }
 
 bool extract(QString srcPath, QString dstDirPath)
 {
-    return !JlCompress::extractDir(srcPath, dstDirPath).empty();
+    return extract(srcPath, dstDirPath, [](const QString&) { return true; });
+}
+
+bool extract(QString srcPath, QString dstDirPath,
+             const std::function<bool(const QString&)>& isNeeded)
+{
+    QFile file(srcPath);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    auto archive = mapArchive(file);
+    QBuffer buffer;
+    QuaZip zip;
+    if (!openArchive(zip, buffer, srcPath, archive))
+        return false;
+
+    QDir dstDir(dstDirPath);
+    QString dstRootPath = QDir::cleanPath(dstDir.absolutePath()) + "/";
+    QList<ExtractedEntry> entries;
+    QSet<QString> dirPaths;
+    for (bool isFound = zip.goToFirstFile(); isFound; isFound = zip.goToNextFile()) {
+        QuaZipFileInfo64 info;
+        if (!zip.getCurrentFileInfo(&info))
+            return false;
+        if (!isNeeded(info.name))
+            continue;
+        // Entries must not be written outside the destination dir
+        QString dstPath = QDir::cleanPath(dstDir.absoluteFilePath(info.name));
+        if (!dstPath.startsWith(dstRootPath))
+            return false;
+        if (info.name.endsWith('/')) {
+            dirPaths.insert(dstPath);
+            continue;
+        }
+        ExtractedEntry entry;
+        entry.dstPath = dstPath;
+        entry.size = static_cast<qint64>(info.uncompressedSize);
+        if (unzGetFilePos64(zip.getUnzFile(), &entry.position) != UNZ_OK)
+            return false;
+        dirPaths.insert(QFileInfo(dstPath).absolutePath());
+        entries.append(entry);
+    }
+    if (zip.getZipError() != UNZ_OK)
+        return false;
+    zip.close();
+    // Nothing selected is nothing to fail on
+    if (entries.isEmpty() && dirPaths.isEmpty())
+        return true;
+
+    foreach (const auto& dirPath, dirPaths) {
+        if (!dstDir.mkpath(dirPath))
+            return false;
+    }
+
+    // Largest entries go first, each to the least loaded worker
+    std::sort(entries.begin(), entries.end(),
+              [](const ExtractedEntry& entry1, const ExtractedEntry& entry2) {
+        return entry1.size > entry2.size;
+    });
+    QThreadPool pool;
+    QVector<ExtractGroup> groups(qMin(pool.maxThreadCount(), qMax(entries.size(), 1)));
+    foreach (const auto& entry, entries) {
+        auto group = std::min_element(groups.begin(), groups.end(),
+                                      [](const ExtractGroup& group1, const ExtractGroup& group2) {
+            return group1.size < group2.size;
+        });
+        group->entries.append(entry);
+        group->size += entry.size;
+    }
+
+    QVector<char> areExtracted(groups.size(), false);
+    runAll(pool, groups.size(), [&](int i) {
+        areExtracted[i] = extractGroup(srcPath, archive, groups[i]);
+    });
+    return !areExtracted.contains(false);
+}
+
+ZipReader::ZipReader(QString path)
+    : path(path)
+{}
+
+bool ZipReader::open()
+{
+    entries.clear();
+    names.clear();
+    archive.clear();
+    file.close();
+    file.setFileName(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    archive = mapArchive(file);
+    QBuffer buffer;
+    QuaZip zip;
+    if (!openArchive(zip, buffer, path, archive))
+        return false;
+
+    for (bool isFound = zip.goToFirstFile(); isFound; isFound = zip.goToNextFile()) {
+        QuaZipFileInfo64 info;
+        if (!zip.getCurrentFileInfo(&info))
+            return false;
+        if (info.name.endsWith('/'))
+            continue;
+        unz64_file_pos position;
+        if (unzGetFilePos64(zip.getUnzFile(), &position) != UNZ_OK)
+            return false;
+        QString name = QDir::cleanPath(info.name);
+        if (entries.contains(name))
+            continue;
+        entries[name] = Entry{ position.pos_in_zip_directory, position.num_of_file,
+                               static_cast<qint64>(info.uncompressedSize) };
+        names.append(name);
+    }
+    return zip.getZipError() == UNZ_OK;
+}
+
+const QStringList& ZipReader::fileNames() const
+{
+    return names;
+}
+
+bool ZipReader::contains(QString name) const
+{
+    return entries.contains(QDir::cleanPath(name));
+}
+
+bool ZipReader::read(QString name, QByteArray& data) const
+{
+    auto it = entries.constFind(QDir::cleanPath(name));
+    if (it == entries.cend())
+        return false;
+    QBuffer buffer;
+    QuaZip zip;
+    if (!openArchive(zip, buffer, path, archive))
+        return false;
+    if (!goToEntry(zip, unz64_file_pos{ it->directoryPos, it->fileNum }))
+        return false;
+    QuaZipFile zipFile(&zip);
+    if (!zipFile.open(QIODevice::ReadOnly))
+        return false;
+    data = zipFile.readAll();
+    zipFile.close();
+    return zipFile.getZipError() == UNZ_OK && data.size() == it->size;
+}
+
+bool ZipReader::extractTo(QString name, QString dstPath) const
+{
+    auto it = entries.constFind(QDir::cleanPath(name));
+    if (it == entries.cend())
+        return false;
+    QBuffer buffer;
+    QuaZip zip;
+    if (!openArchive(zip, buffer, path, archive))
+        return false;
+    ExtractedEntry entry;
+    entry.dstPath = dstPath;
+    entry.position = unz64_file_pos{ it->directoryPos, it->fileNum };
+    entry.size = it->size;
+    return extractEntry(zip, entry);
 }
@@ -4,8 +4,101 @@
 #include "omkit_global.h"
 
 #include <QString>
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QSet>
+#include <QStringList>
+#include <functional>
 
-OMKITSHARED_EXPORT bool compress(QString srcDirPath, QString dstPath);
+class QuaZip;
+class QThreadPool;
+
+// Collects files and data for an archive and writes them in one pass.
+// Entries are deflated on a thread pool in batches of bounded size and
+// written in the order they were added; large files are split into chunks
+// deflated in parallel. Already compressed content, such as images, is
+// stored as is. Entries with an archive path that was already added are
+// skipped, so the first added entry wins.
+class OMKITSHARED_EXPORT ZipBuilder
+{
+public:
+    ZipBuilder();
+
+    bool contains(QString archivePath) const;
+    QString newDirPath(QString parentPath, QString dirNamePrefix);
+    bool addFile(QString srcPath, QString archivePath);
+    bool addData(const QByteArray& data, QString archivePath);
+    bool addDir(QString srcDirPath, QString archivePath);
+    bool write(QString dstPath);
+
+    // Zip64 is turned on by itself for large archives and many entries
+    bool isZip64Enabled;
+    // 0 uses all cores, 1 deflates on the calling thread
+    int threadCount;
+    // zlib level from 0 to 9, or -1 for the default one
+    int compressionLevel;
+
+private:
+    struct Entry {
+        QString archivePath;
+        QString srcPath;
+        QByteArray data;
+        qint64 size;
+    };
+
+    bool addEntry(const Entry& entry);
+    bool needsZip64() const;
+    bool writeBatch(QuaZip& zip, int begin, int end, QThreadPool& pool) const;
+    bool writeLarge(QuaZip& zip, const Entry& entry, QThreadPool& pool) const;
+    bool writeChunked(QuaZip& zip, const Entry& entry, QThreadPool& pool) const;
+
+    QList<Entry> entries;
+    QSet<QString> archivePaths;
+    QSet<QString> dirPaths;
+    qint64 totalSize;
+};
+
+// Reads single files of an archive without extracting it. The archive is
+// mapped once and every read opens its own reader of the mapping, so reads
+// may run on several threads at once.
+class OMKITSHARED_EXPORT ZipReader
+{
+public:
+    ZipReader(QString path);
+
+    bool open();
+    const QStringList& fileNames() const;
+    bool contains(QString name) const;
+    bool read(QString name, QByteArray& data) const;
+    bool extractTo(QString name, QString dstPath) const;
+
+    QString path;
+
+private:
+    Q_DISABLE_COPY(ZipReader)
+
+    struct Entry {
+        quint64 directoryPos;
+        quint64 fileNum;
+        qint64 size;
+    };
+
+    QFile file;
+    QByteArray archive;
+    QHash<QString, Entry> entries;
+    QStringList names;
+};
+
+OMKITSHARED_EXPORT bool compress(QString srcDirPath, QString dstPath, int threadCount = 0,
+                                 int compressionLevel = -1);
+// Entries are inflated in parallel from the mapped archive, directories are
+// created beforehand and every file is preallocated to its final size.
+// Entries that would end up outside the destination dir fail the extraction.
 OMKITSHARED_EXPORT bool extract(QString srcPath, QString dstDirPath);
+// Extracts only entries with archive paths accepted by the predicate
+OMKITSHARED_EXPORT bool extract(QString srcPath, QString dstDirPath,
+                                const std::function<bool(const QString&)>& isNeeded);
 
 #endif // ZIP_UTILS_H
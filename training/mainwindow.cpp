@@ -7,10 +7,14 @@
 #include "group_utils.h"
 #include "solution_utils.h"
 #include "settings.h"
+#include "remotesync.h"
+#include "savequeue.h"
+#include "outbox_utils.h"
 
 #include <omkit/utils.h>
 #include <omkit/string_utils.h>
 #include <omkit/omkit.h>
+#include <omkit/sectioncatalog.h>
 
 #include <QMessageBox>
 #include <QTimer>
@@ -40,6 +44,14 @@ MainWindow::MainWindow(QWidget *parent) :
 
     connect(loginForm, SIGNAL(login()), this, SLOT(onLogin()));
     connect(sectionsForm, SIGNAL(requestedOpen(Section)), this, SLOT(openSection(Section)));
+    connect(sectionsForm, SIGNAL(requestedRebuild()), this, SLOT(rebuildSections()));
+
+    saveQueue = new SaveQueue(this);
+
+    remoteSync = new RemoteSync(this);
+    connect(remoteSync, SIGNAL(stateChanged()), this, SLOT(onSyncStateChanged()));
+    connect(remoteSync, SIGNAL(synced()), sectionsForm, SLOT(updateProgress()));
+    connect(saveQueue, SIGNAL(remotePending(QUuid)), remoteSync, SLOT(retry()));
 
     QTimer::singleShot(0, this, SLOT(loadSettings()));
 }
@@ -60,7 +72,24 @@ void MainWindow::loadSettings()
 
     loadGroups();
     loginForm->init();
-    sectionsForm->setSections(Section::findAll(settings.sectionsPath));
+    loadSections();
+}
+
+void MainWindow::loadSections(bool forceRebuild)
+{
+    const auto& settings = Settings::instance();
+    SectionCatalog catalog(settings.localSectionCatalogPath());
+    if (!forceRebuild)
+        catalog.read();
+    sectionsForm->setSections(catalog.findAll(settings.sectionsPath, forceRebuild));
+    sectionsForm->setCatalogStats(catalog.hits(), catalog.misses());
+    catalog.write();
+}
+
+void MainWindow::rebuildSections()
+{
+    loadSections(true);
+    sectionsForm->updateProgress();
 }
 
 void MainWindow::onLogin()
@@ -68,10 +97,12 @@ void MainWindow::onLogin()
     showMaximized();
     setUserName(loginForm->userName());
     loadSolutions();
+    loadOutbox();
     sectionsForm->setUserName(loginForm->userName());
     sectionsForm->updateProgress();
     ui->tabWidget->setCurrentWidget(sectionsForm);
     ui->stackedWidget->setCurrentWidget(ui->mainPage);
+    remoteSync->start();
 }
 
 void MainWindow::openSection(const Section& section)
@@ -80,7 +111,7 @@ void MainWindow::openSection(const Section& section)
         ui->tabWidget->setCurrentWidget(openedPages[section.id]);
         return;
     }
-    TrainingForm* trainingForm = new TrainingForm(this);
+    TrainingForm* trainingForm = new TrainingForm(saveQueue, remoteSync, this);
     if (!trainingForm->setSection(section)) {
         QMessageBox::warning(this, "Ошибка при открытии",
                              "Не удалось открыть раздел.");
@@ -92,6 +123,7 @@ void MainWindow::openSection(const Section& section)
     openedPages[section.id] = trainingForm;
     connect(trainingForm, SIGNAL(savedSolution(Solution)),
             this, SLOT(onSolutionSaved(Solution)));
+    connect(remoteSync, SIGNAL(synced()), trainingForm, SLOT(updatePendingAnswers()));
 }
 
 void MainWindow::onSolutionSaved(const Solution&)
@@ -99,6 +131,11 @@ void MainWindow::onSolutionSaved(const Solution&)
     sectionsForm->updateProgress();
 }
 
+void MainWindow::onSyncStateChanged()
+{
+    sectionsForm->setSyncState(remoteSync->state(), remoteSync->lastSyncTime());
+}
+
 void MainWindow::on_tabWidget_tabCloseRequested(int index)
 {
     if (index == ui->tabWidget->indexOf(sectionsForm))
@@ -119,6 +156,7 @@ void MainWindow::closeEvent(QCloseEvent* event)
             return;
         }
     }
+    saveQueue->flush();
     event->accept();
 }
 
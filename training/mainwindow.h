@@ -13,6 +13,8 @@ class LoginForm;
 class SectionsForm;
 class Solution;
 class TrainingForm;
+class RemoteSync;
+class SaveQueue;
 
 class MainWindow : public QMainWindow
 {
@@ -24,9 +26,11 @@ public:
 
 private slots:
     void loadSettings();
+    void rebuildSections();
     void onLogin();
     void openSection(const Section& section);
     void onSolutionSaved(const Solution& solution);
+    void onSyncStateChanged();
 
     void on_tabWidget_tabCloseRequested(int index);
 
@@ -36,11 +40,14 @@ protected:
 
 private:
     void select(QWidget* widget);
+    void loadSections(bool forceRebuild = false);
     bool closePage(TrainingForm* trainingForm);
 
     Ui::MainWindow *ui;
     LoginForm* loginForm;
     SectionsForm* sectionsForm;
+    RemoteSync* remoteSync;
+    SaveQueue* saveQueue;
     QHash<QUuid, QWidget*> openedPages;
 };
 
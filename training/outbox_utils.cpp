@@ -0,0 +1,87 @@
+#include "outbox_utils.h"
+#include "user_utils.h"
+#include "settings.h"
+#include <omkit/json_utils.h>
+#include <QDir>
+#include <QJsonArray>
+#include <QMutex>
+
+namespace {
+QList<OutboxEntry> entries;
+QMutex outboxMutex;
+
+QString outboxPath()
+{
+    QString path = getUserPath(Settings::instance().localDataPath());
+    if (path.isEmpty())
+        return QString();
+    return QDir(path).absoluteFilePath("outbox.json");
+}
+
+bool writeOutbox()
+{
+    QJsonArray entriesArray;
+    foreach (const auto& entry, entries) {
+        QJsonObject entryObj;
+        entryObj["sectionId"] = entry.first.toString();
+        entryObj["caseId"] = entry.second.toString();
+        entriesArray.append(entryObj);
+    }
+    QJsonObject rootObj;
+    rootObj["answers"] = entriesArray;
+    return writeJSON(outboxPath(), rootObj);
+}
+} // namespace
+
+void loadOutbox()
+{
+    QMutexLocker locker(&outboxMutex);
+    entries.clear();
+    QJsonObject rootObj;
+    if (!readJSON(outboxPath(), rootObj))
+        return;
+    foreach (auto entryValue, rootObj["answers"].toArray()) {
+        auto entryObj = entryValue.toObject();
+        OutboxEntry entry(QUuid(entryObj["sectionId"].toString("")),
+                          QUuid(entryObj["caseId"].toString("")));
+        if (!entry.first.isNull() && !entry.second.isNull() && !entries.contains(entry))
+            entries.append(entry);
+    }
+}
+
+void addToOutbox(const QUuid& sectionId, const QUuid& caseId)
+{
+    QMutexLocker locker(&outboxMutex);
+    OutboxEntry entry(sectionId, caseId);
+    if (entries.contains(entry))
+        return;
+    entries.append(entry);
+    writeOutbox();
+}
+
+void removeFromOutbox(const QList<OutboxEntry>& sentEntries)
+{
+    QMutexLocker locker(&outboxMutex);
+    bool isChanged = false;
+    foreach (const auto& entry, sentEntries)
+        isChanged = entries.removeOne(entry) || isChanged;
+    if (isChanged)
+        writeOutbox();
+}
+
+QList<OutboxEntry> outboxEntries()
+{
+    QMutexLocker locker(&outboxMutex);
+    return entries;
+}
+
+int outboxSize(const QUuid& sectionId)
+{
+    QMutexLocker locker(&outboxMutex);
+    int size = 0;
+    foreach (const auto& entry, entries) {
+        if (entry.first == sectionId)
+            size++;
+    }
+    return size;
+}
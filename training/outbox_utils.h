@@ -0,0 +1,19 @@
+#ifndef OUTBOX_UTILS_H
+#define OUTBOX_UTILS_H
+
+#include <QList>
+#include <QPair>
+#include <QUuid>
+
+// Answers saved locally but not yet written to the remote dir. The outbox
+// is kept in the local data of the user, so pending answers survive a
+// restart. All the functions are thread-safe.
+typedef QPair<QUuid, QUuid> OutboxEntry; // section id and case id
+
+void loadOutbox();
+void addToOutbox(const QUuid& sectionId, const QUuid& caseId);
+void removeFromOutbox(const QList<OutboxEntry>& entries);
+QList<OutboxEntry> outboxEntries();
+int outboxSize(const QUuid& sectionId);
+
+#endif // OUTBOX_UTILS_H
@@ -1,5 +1,6 @@
 #include "questionpage.h"
 #include "solution_utils.h"
+#include "savequeue.h"
 #include "ui_questionpage.h"
 #include <omkit/html_utils.h>
 
@@ -46,22 +47,12 @@ bool QuestionPage::loadCase(const Section& section, const Case& caseValue)
     return true;
 }
 
-bool QuestionPage::saveAnswer(Solution& solution)
+void QuestionPage::saveAnswer(SaveQueue* saveQueue, bool isRemoteSaved)
 {
-    Solution solutionCopy = solution;
-    Answer& answer = solutionCopy.addAnswer(caseValue);
-    if (hasFinalAnswer) {
-        answer.markAsFinal();
-    } else {
-        answer.version++;
-    }
-    QDir solutionDir = solutionCopy.dir();
-    QString answerFileName = solutionDir.absoluteFilePath(answer.fileName);
-    if (!writeHTML(answerFileName, ui->answerEdit->document()))
-        return false;
-    solution = solutionCopy;
+    // Same bytes as writeHTML() produces
+    QByteArray html = ui->answerEdit->document()->toHtml("utf-8").toUtf8();
+    saveQueue->enqueue(section, caseValue, html, hasFinalAnswer, isRemoteSaved);
     ui->answerEdit->document()->setModified(false);
-    return true;
 }
 
 void QuestionPage::connectWith(QListWidgetItem* item)
@@ -11,7 +11,7 @@ class QuestionPage;
 }
 
 class QListWidgetItem;
-class Solution;
+class SaveQueue;
 
 class QuestionPage : public QWidget
 {
@@ -22,7 +22,7 @@ public:
     ~QuestionPage();
 
     bool loadCase(const Section& section, const Case& caseValue);
-    bool saveAnswer(Solution& solution);
+    void saveAnswer(SaveQueue* saveQueue, bool isRemoteSaved);
     void connectWith(QListWidgetItem* item);
     bool isAnswered() const;
     bool isModified() const;
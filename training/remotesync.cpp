@@ -0,0 +1,95 @@
+#include "remotesync.h"
+#include "solution_utils.h"
+#include "outbox_utils.h"
+#include "settings.h"
+#include <QFutureWatcher>
+#include <QTimer>
+#include <QtConcurrent>
+
+namespace {
+const int SYNC_INTERVAL = 5 * 60 * 1000;
+const int MIN_RETRY_DELAY = 5 * 1000;
+
+bool syncAndSendOutbox()
+{
+    // Answers queued during the sync are sent by the next one
+    auto entries = outboxEntries();
+    if (!syncWithRemote())
+        return false;
+    removeFromOutbox(entries);
+    return true;
+}
+}
+
+RemoteSync::RemoteSync(QObject *parent)
+    : QObject(parent)
+    , watcher(new QFutureWatcher<bool>(this))
+    , timer(new QTimer(this))
+    , retryTimer(new QTimer(this))
+    , retryDelay(MIN_RETRY_DELAY)
+    , currentState(State::Disabled)
+{
+    timer->setInterval(SYNC_INTERVAL);
+    retryTimer->setSingleShot(true);
+    connect(timer, SIGNAL(timeout()), this, SLOT(sync()));
+    connect(retryTimer, SIGNAL(timeout()), this, SLOT(sync()));
+    connect(watcher, SIGNAL(finished()), this, SLOT(onFinished()));
+}
+
+void RemoteSync::start()
+{
+    if (Settings::instance().solutionsPath.isEmpty()) {
+        setState(State::Disabled);
+        return;
+    }
+    sync();
+    timer->start();
+}
+
+RemoteSync::State RemoteSync::state() const
+{
+    return currentState;
+}
+
+QDateTime RemoteSync::lastSyncTime() const
+{
+    return lastSyncDateTime;
+}
+
+void RemoteSync::sync()
+{
+    if (watcher->isRunning())
+        return;
+    retryTimer->stop();
+    setState(State::Syncing);
+    watcher->setFuture(QtConcurrent::run(syncAndSendOutbox));
+}
+
+void RemoteSync::retry()
+{
+    if (currentState == State::Disabled || watcher->isRunning() || retryTimer->isActive())
+        return;
+    retryTimer->start(retryDelay);
+}
+
+void RemoteSync::onFinished()
+{
+    if (watcher->result()) {
+        lastSyncDateTime = QDateTime::currentDateTime();
+        retryDelay = MIN_RETRY_DELAY;
+        setState(State::Synced);
+        emit synced();
+    } else {
+        setState(State::Failed);
+        if (!outboxEntries().isEmpty()) {
+            retryTimer->start(retryDelay);
+            retryDelay = qMin(retryDelay * 2, SYNC_INTERVAL);
+        }
+    }
+}
+
+void RemoteSync::setState(State newState)
+{
+    currentState = newState;
+    emit stateChanged();
+}
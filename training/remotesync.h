@@ -0,0 +1,53 @@
+#ifndef REMOTESYNC_H
+#define REMOTESYNC_H
+
+#include <QObject>
+#include <QDateTime>
+
+template <typename T> class QFutureWatcher;
+class QTimer;
+
+// Synchronizes solutions with the remote dir on a worker thread, right
+// after login and then periodically, so the UI never waits for the share.
+// While the outbox holds answers, failed syncs are retried with backoff.
+class RemoteSync : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class State {
+        Disabled,
+        Syncing,
+        Synced,
+        Failed
+    };
+
+    explicit RemoteSync(QObject *parent = 0);
+
+    void start();
+    State state() const;
+    QDateTime lastSyncTime() const;
+
+public slots:
+    void sync();
+    void retry();
+
+signals:
+    void stateChanged();
+    void synced();
+
+private slots:
+    void onFinished();
+
+private:
+    void setState(State newState);
+
+    QFutureWatcher<bool>* watcher;
+    QTimer* timer;
+    QTimer* retryTimer;
+    int retryDelay;
+    State currentState;
+    QDateTime lastSyncDateTime;
+};
+
+#endif // REMOTESYNC_H
@@ -0,0 +1,124 @@
+#include "savequeue.h"
+#include "outbox_utils.h"
+#include <QCryptographicHash>
+#include <QSaveFile>
+
+bool operator==(const SaveQueue::Key& key1, const SaveQueue::Key& key2)
+{
+    return key1.sectionId == key2.sectionId && key1.caseId == key2.caseId;
+}
+
+uint qHash(const SaveQueue::Key& key, uint seed)
+{
+    return qHash(key.sectionId, seed) ^ qHash(key.caseId, seed);
+}
+
+SaveQueue::SaveQueue(QObject *parent)
+    : QThread(parent)
+    , isBusy(false)
+    , isStopped(false)
+    , hasLocalErrors(false)
+{
+    start();
+}
+
+SaveQueue::~SaveQueue()
+{
+    // Answers still in the queue are written before the thread quits
+    {
+        QMutexLocker locker(&mutex);
+        isStopped = true;
+        jobAdded.wakeAll();
+    }
+    wait();
+}
+
+void SaveQueue::enqueue(const Section& section, const Case& caseValue, const QByteArray& html,
+                        bool isFinal, bool isRemoteSaved)
+{
+    QMutexLocker locker(&mutex);
+    Key key{ section.id, caseValue.id };
+    auto it = jobs.find(key);
+    if (it == jobs.end()) {
+        order.append(key);
+        jobs[key] = Job{ section, caseValue, html, isFinal, isRemoteSaved };
+    } else {
+        it->html = html;
+        it->isFinal = it->isFinal || isFinal;
+        it->isRemoteSaved = it->isRemoteSaved || isRemoteSaved;
+    }
+    jobAdded.wakeOne();
+}
+
+bool SaveQueue::flush()
+{
+    QMutexLocker locker(&mutex);
+    while (!order.isEmpty() || isBusy)
+        jobsDone.wait(&mutex);
+    bool isSaved = !hasLocalErrors;
+    hasLocalErrors = false;
+    return isSaved;
+}
+
+void SaveQueue::run()
+{
+    QMutexLocker locker(&mutex);
+    forever {
+        while (order.isEmpty() && !isStopped)
+            jobAdded.wait(&mutex);
+        if (order.isEmpty())
+            break;
+
+        Key key = order.takeFirst();
+        Job job = jobs.take(key);
+        isBusy = true;
+        locker.unlock();
+
+        bool isSavedLocally = save(SolutionPathType::Local, job);
+        if (job.isRemoteSaved) {
+            // Unsent answers are kept in the outbox before anything else
+            // is reported, so they are not lost when the app quits
+            if (isRemoteSynced() && save(SolutionPathType::Remote, job)) {
+                removeFromOutbox(QList<OutboxEntry>() << OutboxEntry(key.sectionId, key.caseId));
+            } else {
+                addToOutbox(key.sectionId, key.caseId);
+                emit remotePending(key.sectionId);
+            }
+        }
+        if (isSavedLocally)
+            emit saved(key.sectionId, key.caseId);
+        else
+            emit saveFailed(key.sectionId, key.caseId);
+
+        locker.relock();
+        isBusy = false;
+        hasLocalErrors = hasLocalErrors || !isSavedLocally;
+        if (order.isEmpty())
+            jobsDone.wakeAll();
+    }
+    jobsDone.wakeAll();
+}
+
+bool SaveQueue::save(SolutionPathType type, const Job& job)
+{
+    return updateSolution(type, job.section, [&job](Solution& solution) {
+        Answer answer = solution.answer(job.caseValue);
+        if (!answer.isValid())
+            answer = Answer::createAnswer(job.caseValue);
+        if (job.isFinal)
+            answer.markAsFinal();
+        else
+            answer.version++;
+
+        QSaveFile file(solution.dir().absoluteFilePath(answer.fileName));
+        file.setDirectWriteFallback(true);
+        if (!file.open(QIODevice::WriteOnly))
+            return false;
+        if (file.write(job.html) != job.html.size() || !file.commit())
+            return false;
+        answer.hash = QString::fromLatin1(
+                    QCryptographicHash::hash(job.html, QCryptographicHash::Sha1).toHex());
+        solution.setAnswer(answer);
+        return true;
+    });
+}
@@ -0,0 +1,70 @@
+#ifndef SAVEQUEUE_H
+#define SAVEQUEUE_H
+
+#include "solution_utils.h"
+#include <omkit/section.h>
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QThread>
+#include <QUuid>
+#include <QWaitCondition>
+
+// Writes answers and their solutions on a dedicated I/O thread, so a slow
+// remote dir never stalls the UI. Answers are snapshotted to HTML on the UI
+// thread; a newer snapshot of the same answer replaces a queued one.
+class SaveQueue : public QThread
+{
+    Q_OBJECT
+
+public:
+    explicit SaveQueue(QObject *parent = 0);
+    ~SaveQueue();
+
+    void enqueue(const Section& section, const Case& caseValue, const QByteArray& html,
+                 bool isFinal, bool isRemoteSaved);
+    // Waits until everything queued is written. Returns false if a local
+    // save failed since the previous flush.
+    bool flush();
+
+signals:
+    void saved(QUuid sectionId, QUuid caseId);
+    void saveFailed(QUuid sectionId, QUuid caseId);
+    // The answer was not written to the remote dir and waits in the outbox
+    void remotePending(QUuid sectionId);
+
+protected:
+    void run() override;
+
+private:
+    struct Key {
+        QUuid sectionId;
+        QUuid caseId;
+    };
+
+    struct Job {
+        Section section;
+        Case caseValue;
+        QByteArray html;
+        bool isFinal;
+        bool isRemoteSaved;
+    };
+
+    friend bool operator==(const Key& key1, const Key& key2);
+    friend uint qHash(const Key& key, uint seed);
+
+    bool save(SolutionPathType type, const Job& job);
+
+    QMutex mutex;
+    QWaitCondition jobAdded;
+    QWaitCondition jobsDone;
+    QList<Key> order;
+    QHash<Key, Job> jobs;
+    bool isBusy;
+    bool isStopped;
+    bool hasLocalErrors;
+};
+
+#endif // SAVEQUEUE_H
@@ -7,6 +7,8 @@ SectionsForm::SectionsForm(QWidget *parent) :
     ui(new Ui::SectionsForm)
 {
     ui->setupUi(this);
+    ui->syncStateLabel->hide();
+    connect(ui->rebuildButton, SIGNAL(clicked()), this, SIGNAL(requestedRebuild()));
 }
 
 SectionsForm::~SectionsForm()
@@ -19,8 +21,37 @@ void SectionsForm::setUserName(QString name)
     ui->greetingsLabel->setText("Здравствуйте, " + name + "!");
 }
 
+void SectionsForm::setSyncState(RemoteSync::State state, QDateTime lastSyncTime)
+{
+    ui->syncStateLabel->setVisible(state != RemoteSync::State::Disabled);
+    switch (state) {
+    case RemoteSync::State::Disabled:
+        break;
+    case RemoteSync::State::Syncing:
+        ui->syncStateLabel->setText("Синхронизация ответов с сервером...");
+        break;
+    case RemoteSync::State::Synced:
+        ui->syncStateLabel->setText("Ответы синхронизированы с сервером в "
+                                    + lastSyncTime.toString("HH:mm"));
+        break;
+    case RemoteSync::State::Failed:
+        ui->syncStateLabel->setText("Нет доступа к папке для ответов на сервере. "
+                                    "Ответы сохраняются локально.");
+        break;
+    }
+}
+
+void SectionsForm::setCatalogStats(int cachedNum, int parsedNum)
+{
+    ui->rebuildButton->setToolTip(QString("Заново прочитать все разделы, не используя кэш.\n"
+                                          "Разделов из кэша: %1, прочитано заново: %2")
+                                  .arg(cachedNum)
+                                  .arg(parsedNum));
+}
+
 void SectionsForm::setSections(QList<Section> sections)
 {
+    qDeleteAll(sectionWidgets);
     sectionWidgets.clear();
     foreach (const auto& section, sections) {
         SectionWidget* widget = new SectionWidget(this);
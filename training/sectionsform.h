@@ -1,6 +1,7 @@
 #ifndef SECTIONSFORM_H
 #define SECTIONSFORM_H
 
+#include "remotesync.h"
 #include <omkit/section.h>
 
 #include <QList>
@@ -21,9 +22,12 @@ public:
     ~SectionsForm();
 
     void setUserName(QString name);
+    void setSyncState(RemoteSync::State state, QDateTime lastSyncTime);
+    void setCatalogStats(int cachedNum, int parsedNum);
 
 signals:
     void requestedOpen(Section);
+    void requestedRebuild();
 
 public slots:
     void setSections(QList<Section> sections);
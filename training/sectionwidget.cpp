@@ -38,28 +38,25 @@ void SectionWidget::updateProgress()
 {
     if (!hasSolution(SolutionPathType::Local, section))
         return;
-    const Solution& solution = peekSolution(SolutionPathType::Local, section);
-    int answersNum = solution.finalAnswersNum();
-    if (solution.isValid()) {
-        ui->progressBar->setValue(answersNum);
-        if (ui->progressBar->maximum() == answersNum) {
-            ui->enterButton->setText("Просмотреть");
-            auto font = ui->progressBar->font();
-            ui->progressBar->setStyleSheet(
-                    R"delim(
-                    QProgressBar {
-                        border: 2px solid grey;
-                        border-radius: 5px;
-                        text-align: center;
-                    }
-                    QProgressBar::chunk {
-                        background-color: rgb(15, 255, 60);
-                        width: 20px;
-                    })delim");
-            ui->progressBar->setFont(font);
-        } else {
-            ui->enterButton->setText("Продолжить");
-        }
+    auto stats = getCompletionStats(section);
+    ui->progressBar->setValue(stats.finalAnswersNum);
+    if (stats.isCompleted) {
+        ui->enterButton->setText("Просмотреть");
+        auto font = ui->progressBar->font();
+        ui->progressBar->setStyleSheet(
+                R"delim(
+                QProgressBar {
+                    border: 2px solid grey;
+                    border-radius: 5px;
+                    text-align: center;
+                }
+                QProgressBar::chunk {
+                    background-color: rgb(15, 255, 60);
+                    width: 20px;
+                })delim");
+        ui->progressBar->setFont(font);
+    } else {
+        ui->enterButton->setText("Продолжить");
     }
 }
 
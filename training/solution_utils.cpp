@@ -2,8 +2,11 @@
 #include "user_utils.h"
 #include "settings.h"
 #include <omkit/utils.h>
+#include <omkit/solutionmanifest.h>
 #include <QFileInfo>
 #include <QHash>
+#include <QMutex>
+#include <QSharedPointer>
 
 namespace {
 struct SolutionKey {
@@ -35,7 +38,38 @@ QString pathByType(SolutionPathType type)
 }
 
 QHash<SolutionKey, Solution> solutions;
+// Bumped on every change of a solution in the map
+QHash<SolutionKey, quint64> revisions;
 bool isSynced = false;
+// Remote sync runs on a worker thread. The mutex guards only the maps and
+// is never held during I/O, so the UI does not wait for the remote dir.
+QMutex solutionsMutex(QMutex::Recursive);
+// Writes to the files of a section's solutions, local and remote, are
+// serialized by a lock of their own, so a solution is never merged and
+// saved at the same time. It is taken before solutionsMutex, never after.
+QHash<QUuid, QSharedPointer<QMutex>> ioMutexes;
+QMutex manifestMutex;
+// Stats of the local solutions by section id. Case lists do not change
+// while the app runs, so an entry is dropped only when its solution is.
+QHash<QUuid, CompletionStats> completionStats;
+
+QMutex* ioMutexOf(QUuid sectionId)
+{
+    QMutexLocker locker(&solutionsMutex);
+    auto& mutex = ioMutexes[sectionId];
+    if (!mutex)
+        mutex = QSharedPointer<QMutex>(new QMutex(QMutex::Recursive));
+    return mutex.data();
+}
+
+void setSolution(const SolutionKey& key, const Solution& solution)
+{
+    QMutexLocker locker(&solutionsMutex);
+    solutions[key] = solution;
+    revisions[key]++;
+    if (key.type == SolutionPathType::Local)
+        completionStats.remove(key.sectionId);
+}
 
 bool loadSolutionsFrom(SolutionPathType type)
 {
@@ -47,11 +81,23 @@ bool loadSolutionsFrom(SolutionPathType type)
     if (path.isEmpty())
         return false;
 
+    QHash<SolutionKey, quint64> oldRevisions;
+    {
+        QMutexLocker locker(&solutionsMutex);
+        oldRevisions = revisions;
+    }
+    // Listing a network share is slow, so it is done without the lock
     auto newSolutions = Solution::findAll(path);
+    QString name = userName();
+    QMutexLocker locker(&solutionsMutex);
     foreach (const auto& solution, newSolutions) {
-        if (solution.userName != userName())
+        if (solution.userName != name)
             continue;
-        solutions[SolutionKey{ type, solution.sectionId.toString() }] = solution;
+        // A solution saved during the listing is newer than the one read
+        SolutionKey key{ type, solution.sectionId };
+        if (revisions.value(key) != oldRevisions.value(key))
+            continue;
+        setSolution(key, solution);
     }
     return true;
 }
@@ -74,51 +120,150 @@ bool setSolutionDir(SolutionPathType type, Solution& solution)
     return true;
 }
 
-void sync(SolutionPathType from, SolutionPathType to)
+// Keeps the entries of otherEntries missing from entries and the newer of
+// the answer versions of those in both
+void mergeManifestEntries(QList<SolutionManifest::Entry>& entries,
+                          const QList<SolutionManifest::Entry>& otherEntries)
 {
-    auto solutionsCopy = solutions;
-    for (auto it = solutionsCopy.begin(); it != solutionsCopy.end(); ++it) {
-        const auto& srcKey = it.key();
-        if (srcKey.type != from)
+    QHash<QString, int> indexes;
+    for (int i = 0; i < entries.size(); ++i)
+        indexes[entries[i].filePath] = i;
+    foreach (const auto& otherEntry, otherEntries) {
+        auto it = indexes.constFind(otherEntry.filePath);
+        if (it == indexes.cend()) {
+            entries.append(otherEntry);
             continue;
-        const auto& srcSolution = it.value();
+        }
+        auto& versions = entries[it.value()].versions;
+        for (auto versionIt = otherEntry.versions.cbegin();
+             versionIt != otherEntry.versions.cend(); ++versionIt) {
+            if (versions.value(versionIt.key(), -1) < versionIt.value())
+                versions[versionIt.key()] = versionIt.value();
+        }
+    }
+}
+
+// Lets control find out what changed without listing the user dir
+bool updateRemoteManifest()
+{
+    QString rootPath = pathByType(SolutionPathType::Remote);
+    if (rootPath.isEmpty())
+        return false;
+    QString userPath = getUserPath(rootPath);
+    if (userPath.isEmpty())
+        return false;
+
+    QDir userDir(userPath);
+    SolutionManifest manifest;
+    manifest.userName = userName();
+    {
+        QMutexLocker locker(&solutionsMutex);
+        for (auto it = solutions.cbegin(); it != solutions.cend(); ++it) {
+            if (it.key().type == SolutionPathType::Remote)
+                manifest.entries.append(SolutionManifest::entryOf(it.value(), userDir));
+        }
+    }
+    QMutexLocker locker(&manifestMutex);
+    // Other machines of the user write the same manifest, so what they
+    // wrote is kept. Without a valid manifest the user dir is read instead.
+    SolutionManifest oldManifest;
+    if (oldManifest.read(rootPath, manifest.userName)) {
+        manifest.generation = oldManifest.generation;
+        mergeManifestEntries(manifest.entries, oldManifest.entries);
+    } else {
+        QList<SolutionManifest::Entry> entries;
+        foreach (const auto& solution, Solution::findAll(userPath))
+            entries.append(SolutionManifest::entryOf(solution, userDir));
+        mergeManifestEntries(manifest.entries, entries);
+    }
+    return manifest.write(rootPath);
+}
+
+bool sync(SolutionPathType from, SolutionPathType to)
+{
+    QList<SolutionKey> srcKeys;
+    {
+        QMutexLocker locker(&solutionsMutex);
+        for (auto it = solutions.cbegin(); it != solutions.cend(); ++it) {
+            if (it.key().type == from)
+                srcKeys.append(it.key());
+        }
+    }
+    // Each solution is merged under the I/O lock of its section only, so
+    // answers of the other sections can be saved meanwhile
+    bool areMerged = true;
+    bool isChanged = false;
+    foreach (const auto& srcKey, srcKeys) {
+        QMutexLocker ioLocker(ioMutexOf(srcKey.sectionId));
         SolutionKey dstKey{ to, srcKey.sectionId };
+        Solution srcSolution;
         Solution dstSolution;
-        if (solutions.contains(dstKey)) {
-            const auto& solutionInMap = solutions[dstKey];
-            if (solutionInMap.isEqual(srcSolution))
+        bool hasDstSolution;
+        {
+            QMutexLocker locker(&solutionsMutex);
+            srcSolution = solutions.value(srcKey);
+            hasDstSolution = solutions.contains(dstKey);
+            dstSolution = solutions.value(dstKey);
+        }
+        if (hasDstSolution) {
+            if (dstSolution.isEqual(srcSolution))
                 continue;
-            dstSolution = solutionInMap;
         } else {
             dstSolution = srcSolution.cloneHeader("");
-            if (!setSolutionDir(to, dstSolution))
+            if (!setSolutionDir(to, dstSolution)) {
+                areMerged = false;
                 continue;
+            }
         }
 
-        if (!dstSolution.merge(srcSolution))
+        if (!dstSolution.merge(srcSolution)) {
+            areMerged = false;
             continue;
-        solutions[dstKey] = dstSolution;
+        }
+        setSolution(dstKey, dstSolution);
+        isChanged = true;
     }
+    if (isChanged && to == SolutionPathType::Remote)
+        updateRemoteManifest();
+    return areMerged;
 }
 
-void syncWithRemote()
-{
-    isSynced = loadSolutionsFrom(SolutionPathType::Remote);
-    if (isSynced) {
-        sync(SolutionPathType::Remote, SolutionPathType::Local);
-        sync(SolutionPathType::Local, SolutionPathType::Remote);
-    }
-}
 } // namespace
 
 void loadSolutions()
 {
     loadSolutionsFrom(SolutionPathType::Local);
-    syncWithRemote();
+}
+
+bool syncWithRemote()
+{
+    bool isLoaded = loadSolutionsFrom(SolutionPathType::Remote);
+    {
+        QMutexLocker locker(&solutionsMutex);
+        isSynced = isLoaded;
+    }
+    if (!isLoaded)
+        return false;
+    bool isReceived = sync(SolutionPathType::Remote, SolutionPathType::Local);
+    bool isSent = sync(SolutionPathType::Local, SolutionPathType::Remote);
+    // The marker is missing after older versions or when control has
+    // changed the user dir
+    QString markerPath = SolutionManifest::markerPath(
+                pathByType(SolutionPathType::Remote), userName());
+    if (!QFileInfo::exists(markerPath))
+        updateRemoteManifest();
+    return isReceived && isSent;
+}
+
+bool isRemoteSynced()
+{
+    QMutexLocker locker(&solutionsMutex);
+    return isSynced;
 }
 
 bool hasSolution(SolutionPathType type, const Section& section)
 {
+    QMutexLocker locker(&solutionsMutex);
     if (type == SolutionPathType::Remote && !isSynced)
         return false;
     return solutions.contains(SolutionKey{ type, section.id });
@@ -126,29 +271,53 @@ bool hasSolution(SolutionPathType type, const Section& section)
 
 Solution getSolution(SolutionPathType type, const Section& section)
 {
-    if (type == SolutionPathType::Remote && !isSynced)
-        return Solution();
-
     SolutionKey key{ type, section.id };
-    if (!solutions.contains(key)) {
-        Solution solution = Solution::createSolution(section);
-        solution.userName = userName();
-        if (!saveSolution(type, solution)) {
+    {
+        QMutexLocker locker(&solutionsMutex);
+        if (type == SolutionPathType::Remote && !isSynced)
             return Solution();
-        }
-        return solution;
+        auto it = solutions.constFind(key);
+        if (it != solutions.cend())
+            return it.value();
+    }
+
+    QMutexLocker ioLocker(ioMutexOf(section.id));
+    // Another thread may have created it while the lock was awaited
+    {
+        QMutexLocker locker(&solutionsMutex);
+        auto it = solutions.constFind(key);
+        if (it != solutions.cend())
+            return it.value();
     }
-    return solutions[key];
+    Solution solution = Solution::createSolution(section);
+    solution.userName = userName();
+    if (!saveSolution(type, solution))
+        return Solution();
+    return solution;
+}
+
+Solution peekSolution(SolutionPathType type, const Section& section)
+{
+    QMutexLocker locker(&solutionsMutex);
+    return solutions.value(SolutionKey{ type, section.id });
 }
 
-const Solution& peekSolution(SolutionPathType type, const Section& section)
+CompletionStats getCompletionStats(const Section& section)
 {
-    return solutions[SolutionKey{ type, section.id }];
+    QMutexLocker locker(&solutionsMutex);
+    auto it = completionStats.constFind(section.id);
+    if (it != completionStats.cend() && it->casesNum == section.cases.size())
+        return it.value();
+    auto stats = CompletionStats::make(
+                section, solutions.value(SolutionKey{ SolutionPathType::Local, section.id }));
+    completionStats[section.id] = stats;
+    return stats;
 }
 
 bool saveSolution(SolutionPathType type, Solution& solution)
 {
-    if (type == SolutionPathType::Remote && !isSynced)
+    QMutexLocker ioLocker(ioMutexOf(solution.sectionId));
+    if (type == SolutionPathType::Remote && !isRemoteSynced())
         return false;
     if (solution.dirPath.isEmpty()) {
         if (!setSolutionDir(type, solution))
@@ -156,14 +325,29 @@ bool saveSolution(SolutionPathType type, Solution& solution)
     }
     if (!solution.save())
         return false;
-    solutions[SolutionKey{ type, solution.sectionId }] = solution;
+    setSolution(SolutionKey{ type, solution.sectionId }, solution);
+    if (type == SolutionPathType::Remote)
+        updateRemoteManifest();
     return true;
 }
 
+bool updateSolution(SolutionPathType type, const Section& section,
+                    const std::function<bool(Solution&)>& change)
+{
+    QMutexLocker ioLocker(ioMutexOf(section.id));
+    Solution solution = getSolution(type, section);
+    if (!solution.isValid())
+        return false;
+    if (!change(solution))
+        return false;
+    return saveSolution(type, solution);
+}
+
 bool mergeSolution(const Solution& srcSolution,
                    SolutionPathType dstType, Solution& dstSolution)
 {
-    if (dstType == SolutionPathType::Remote && !isSynced)
+    QMutexLocker ioLocker(ioMutexOf(dstSolution.sectionId));
+    if (dstType == SolutionPathType::Remote && !isRemoteSynced())
         return false;
     if (dstSolution.dirPath.isEmpty()) {
         if (!saveSolution(dstType, dstSolution))
@@ -171,6 +355,8 @@ bool mergeSolution(const Solution& srcSolution,
     }
     if (!dstSolution.merge(srcSolution))
         return false;
-    solutions[SolutionKey{ dstType, dstSolution.sectionId }] = dstSolution;
+    setSolution(SolutionKey{ dstType, dstSolution.sectionId }, dstSolution);
+    if (dstType == SolutionPathType::Remote)
+        updateRemoteManifest();
     return true;
 }
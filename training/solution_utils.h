@@ -3,8 +3,10 @@
 
 #include <omkit/section.h>
 #include <omkit/solution.h>
+#include <omkit/completionstats.h>
 #include <QDir>
 #include <QString>
+#include <functional>
 
 enum class SolutionPathType {
     Local,
@@ -12,11 +14,22 @@ enum class SolutionPathType {
 };
 
 void loadSolutions();
+// Merges local and remote solutions both ways, returns false if the remote
+// dir is unreachable or some solution failed to merge. May run on a worker
+// thread, all the functions below are thread-safe.
+bool syncWithRemote();
+bool isRemoteSynced();
 
 bool hasSolution(SolutionPathType type, const Section& section);
 Solution getSolution(SolutionPathType type, const Section& section);
-const Solution& peekSolution(SolutionPathType type, const Section& section);
+Solution peekSolution(SolutionPathType type, const Section& section);
+// Stats of the local solution, computed only after it has changed
+CompletionStats getCompletionStats(const Section& section);
 bool saveSolution(SolutionPathType type, Solution& solution);
+// Applies change to the current solution and saves it. No other write to
+// the solution happens in between, so nothing merged meanwhile is lost.
+bool updateSolution(SolutionPathType type, const Section& section,
+                    const std::function<bool(Solution&)>& change);
 bool mergeSolution(const Solution& srcSolution,
                    SolutionPathType dstType, Solution& dstSolution);
 
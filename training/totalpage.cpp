@@ -10,6 +10,7 @@ TotalPage::TotalPage(QWidget *parent) :
     ui(new Ui::TotalPage)
 {
     ui->setupUi(this);
+    ui->pendingLabel->hide();
 
     connect(ui->transferButton, SIGNAL(clicked()), this, SIGNAL(requestedTransfer()));
 }
@@ -53,6 +54,15 @@ void TotalPage::setUnknownState()
     ui->stackedWidget->setCurrentWidget(ui->createArchiveWidget);
 }
 
+void TotalPage::setPendingAnswersNum(int num)
+{
+    ui->pendingLabel->setVisible(num > 0);
+    ui->pendingLabel->setText(QString("Ответов, ожидающих отправки на сервер: %1. "
+                                      "Они будут отправлены автоматически, "
+                                      "как только появится доступ к папке для ответов.")
+                              .arg(num));
+}
+
 void TotalPage::on_archiveButton_clicked()
 {
     QString zipArchiveName = userName() + " " + QFileInfo(sectionPath).baseName() + ".zip";
@@ -22,6 +22,7 @@ public:
     void setSuccess();
     void setTransferError();
     void setUnknownState();
+    void setPendingAnswersNum(int num);
 
 signals:
     void requestedTransfer();
@@ -4,7 +4,7 @@
 #
 #-------------------------------------------------
 
-QT       += core gui
+QT       += core gui concurrent
 
 greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
 
@@ -28,6 +28,9 @@ SOURCES += main.cpp\
     mentoranswerpage.cpp \
     user_utils.cpp \
     solution_utils.cpp \
+    remotesync.cpp \
+    savequeue.cpp \
+    outbox_utils.cpp \
     totalpage.cpp \
     group_utils.cpp
 
@@ -41,6 +44,9 @@ HEADERS  += mainwindow.h \
     mentoranswerpage.h \
     user_utils.h \
     solution_utils.h \
+    remotesync.h \
+    savequeue.h \
+    outbox_utils.h \
     totalpage.h \
     group_utils.h
 
@@ -4,16 +4,27 @@
 #include "totalpage.h"
 #include "solution_utils.h"
 #include "settings.h"
+#include "savequeue.h"
+#include "remotesync.h"
+#include "outbox_utils.h"
 #include "ui_trainingform.h"
 #include <omkit/zip_utils.h>
 #include <omkit/ui_utils.h>
 #include <QMessageBox>
+#include <QFileInfo>
 
-TrainingForm::TrainingForm(QWidget *parent) :
+TrainingForm::TrainingForm(SaveQueue* saveQueue, RemoteSync* remoteSync, QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::TrainingForm)
+    ui(new Ui::TrainingForm),
+    saveQueue(saveQueue),
+    remoteSync(remoteSync)
 {
     ui->setupUi(this);
+    connect(saveQueue, SIGNAL(saved(QUuid,QUuid)), this, SLOT(onAnswerSaved(QUuid,QUuid)));
+    connect(saveQueue, SIGNAL(saveFailed(QUuid,QUuid)),
+            this, SLOT(onAnswerSaveFailed(QUuid,QUuid)));
+    connect(saveQueue, SIGNAL(remotePending(QUuid)), this, SLOT(updatePendingAnswers()));
+    connect(remoteSync, SIGNAL(stateChanged()), this, SLOT(updateTransferState()));
 
     ui->splitter->setStretchFactor(0, 1);
     ui->splitter->setStretchFactor(1, 3);
@@ -52,48 +63,29 @@ bool TrainingForm::setSection(const Section& section)
     instructionItem->setText("Инструкция");
     ui->listWidget->setCurrentItem(instructionItem);
 
+    Solution solution = getSolution(SolutionPathType::Local, section);
+    QDir sectionDir = section.dir();
+    QIcon answeredIcon(":/icons/answered.png");
+    QIcon questionIcon(":/icons/question.png");
     QListWidgetItem* prevItem = nullptr;
     foreach (const auto& caseValue, section.cases) {
-        QuestionPage* questionPage = new QuestionPage;
-        if (!questionPage->loadCase(section, caseValue)) {
-            delete questionPage;
+        if (!QFileInfo::exists(sectionDir.absoluteFilePath(caseValue.questionFileName))) {
             badFiles.append(caseValue.name + "/Вопрос");
             continue;
         }
-
-        MentorAnswerPage* mentorAnswerPage = new MentorAnswerPage;
-        if (!mentorAnswerPage->loadCase(section, caseValue)) {
-            delete questionPage;
-            delete mentorAnswerPage;
+        if (!QFileInfo::exists(sectionDir.absoluteFilePath(caseValue.answerFileName))) {
             badFiles.append(caseValue.name + "/Ответ");
             continue;
         }
 
-        int questionPageId = ui->stackedWidget->addWidget(questionPage);
-        int mentorAnswerPageId = ui->stackedWidget->addWidget(mentorAnswerPage);
         QListWidgetItem* item = new QListWidgetItem(ui->listWidget);
         item->setText(QString("%1. Кейс \"%2\"").arg(nextCaseIndex).arg(caseValue.name));
-        if (questionPage->isAnswered()) {
-            item->setIcon(QIcon(":/icons/answered.png"));
-        } else {
-            item->setIcon(QIcon(":/icons/question.png"));
-        }
-        nodes[item] = NodeDescriptor{ questionPageId, mentorAnswerPageId, nullptr };
+        bool isAnswered = solution.isValid() && solution.answer(caseValue).isFinal();
+        item->setIcon(isAnswered ? answeredIcon : questionIcon);
+        nodes[item] = NodeDescriptor{ caseValue, nullptr, nullptr, nullptr };
         if (prevItem)
             nodes[prevItem].nextItem = item;
 
-        questionPage->connectWith(item);
-        connect(questionPage, SIGNAL(enteredAnswer(QListWidgetItem*)),
-                this, SLOT(onAnswerEntered(QListWidgetItem*)));
-        connect(questionPage, SIGNAL(requestedMentorAnswer(QListWidgetItem*)),
-                this, SLOT(toMentorAnswer(QListWidgetItem*)));
-
-        mentorAnswerPage->connectWith(item);
-        connect(mentorAnswerPage, SIGNAL(requestedBack(QListWidgetItem*)),
-                this, SLOT(backToQuestion(QListWidgetItem*)));
-        connect(mentorAnswerPage, SIGNAL(requestedNext(QListWidgetItem*)),
-                this, SLOT(next(QListWidgetItem*)));
-
         if (!firstCaseItem)
             firstCaseItem = item;
 
@@ -124,47 +116,27 @@ QUuid TrainingForm::sectionId() const
 
 bool TrainingForm::tryClose()
 {
-    QSet<QuestionPage*> questionPages;
-    foreach (const auto& item, nodes) {
-        QWidget* widget = ui->stackedWidget->widget(item.questionPageId);
-        questionPages.insert((QuestionPage*)widget);
-    }
-
-    Solution solution = getSolution(SolutionPathType::Local, section);
-    Solution remoteSolution;
-    if (Settings::instance().answerType() == TrainingAnswerType::RemoteDir)
-        remoteSolution = getSolution(SolutionPathType::Remote, section);
-
-    bool askedAboutError = false;
     bool changedSolution = false;
-    foreach (auto questionPage, questionPages) {
-        if (questionPage->isModified()) {
-            if (solution.isValid()
-                && questionPage->saveAnswer(solution)
-                && saveSolution(SolutionPathType::Local, solution)) {
-                changedSolution = true;
-            } else {
-                if (!askedAboutError) {
-                    askedAboutError = true;
-                    int answer = QMessageBox::question(
-                                this, "Ошибка при сохранении",
-                                "Не удалось сохранить ответы локально. "
-                                "Вы можете потерять введенные вами данные. "
-                                "Все равно закрыть раздел?");
-                    if (answer != QMessageBox::Yes)
-                        return false;
-                }
-            }
-
-            if (remoteSolution.isValid()) {
-                if (questionPage->saveAnswer(remoteSolution))
-                    saveSolution(SolutionPathType::Remote, remoteSolution);
-            }
+    foreach (const auto& node, nodes) {
+        if (node.questionPage && node.questionPage->isModified()) {
+            node.questionPage->saveAnswer(saveQueue, isRemoteSaved());
+            changedSolution = true;
         }
     }
 
+    // Answers must be on disk before the section is closed
+    if (!saveQueue->flush()) {
+        int answer = QMessageBox::question(
+                    this, "Ошибка при сохранении",
+                    "Не удалось сохранить ответы локально. "
+                    "Вы можете потерять введенные вами данные. "
+                    "Все равно закрыть раздел?");
+        if (answer != QMessageBox::Yes)
+            return false;
+    }
+
     if (changedSolution)
-        emit savedSolution(solution);
+        emit savedSolution(getSolution(SolutionPathType::Local, section));
     return true;
 }
 
@@ -182,7 +154,7 @@ void TrainingForm::on_listWidget_itemSelectionChanged()
         ui->stackedWidget->setCurrentWidget(totalPage);
         return;
     }
-    openQuestionPage(nodes[item].questionPageId);
+    openQuestionPage(item);
 }
 
 void TrainingForm::on_startButton_clicked()
@@ -194,53 +166,45 @@ void TrainingForm::onAnswerEntered(QListWidgetItem* caseItem)
 {
     if (!nodes.contains(caseItem))
         return;
-    const auto& node = nodes[caseItem];
-    auto questionPage = (QuestionPage*)ui->stackedWidget->widget(node.questionPageId);
-    Solution solution = getSolution(SolutionPathType::Local, section);
-    bool isSavedLocally = false;
-    if (solution.isValid()
-        && questionPage->saveAnswer(solution)
-        && saveSolution(SolutionPathType::Local, solution)) {
-        caseItem->setIcon(QIcon(":/icons/answered.png"));
-        isSavedLocally = true;
-        emit savedSolution(solution);
-    } else {
-        QMessageBox::warning(this, "Ошибка при сохранении",
-                             "Не удалось сохранить ответ локально. "
-                             "Возможно, приложение настроено неверно.");
-    }
+    // The icon changes once the answer is saved
+    nodes[caseItem].questionPage->saveAnswer(saveQueue, isRemoteSaved());
+    openMentorAnswerPage(caseItem);
+}
 
-    if (Settings::instance().answerType() == TrainingAnswerType::RemoteDir) {
-        solution = getSolution(SolutionPathType::Remote, section);
-        if (!solution.isValid()
-            || !questionPage->saveAnswer(solution)
-            || !saveSolution(SolutionPathType::Remote, solution)) {
-            QMessageBox::warning(this, "Ошибка при сохранении",
-                                 "Не удалось сохранить ответ на сервере. "
-                                 "Нет доступа к папке для ответов."
-                                 + (isSavedLocally ? QString(" Ответ был сохранен локально.") : ""));
-        }
-    }
+void TrainingForm::onAnswerSaved(QUuid sectionId, QUuid caseId)
+{
+    if (sectionId != section.id)
+        return;
+    updateCaseIcon(caseId);
+    emit savedSolution(getSolution(SolutionPathType::Local, section));
+    if (isSectionCompleted())
+        updateTotal();
+}
 
-    if (isSavedLocally) {
-        if (isSectionCompleted())
-            updateTotal();
-    }
-    ui->stackedWidget->setCurrentIndex(node.mentorAnswerPageId);
+void TrainingForm::onAnswerSaveFailed(QUuid sectionId, QUuid caseId)
+{
+    if (sectionId != section.id)
+        return;
+    updateCaseIcon(caseId);
+    QMessageBox::warning(this, "Ошибка при сохранении",
+                         "Не удалось сохранить ответ локально. "
+                         "Возможно, приложение настроено неверно.");
+}
+
+void TrainingForm::updatePendingAnswers()
+{
+    if (totalPage)
+        totalPage->setPendingAnswersNum(outboxSize(section.id));
 }
 
 void TrainingForm::toMentorAnswer(QListWidgetItem* caseItem)
 {
-    if (!nodes.contains(caseItem))
-        return;
-    ui->stackedWidget->setCurrentIndex(nodes[caseItem].mentorAnswerPageId);
+    openMentorAnswerPage(caseItem);
 }
 
 void TrainingForm::backToQuestion(QListWidgetItem* caseItem)
 {
-    if (!nodes.contains(caseItem))
-        return;
-    openQuestionPage(nodes[caseItem].questionPageId);
+    openQuestionPage(caseItem);
 }
 
 void TrainingForm::next(QListWidgetItem* caseItem)
@@ -261,16 +225,15 @@ void TrainingForm::next(QListWidgetItem* caseItem)
 
 void TrainingForm::transferSolution()
 {
-    Solution localSolution = getSolution(SolutionPathType::Local, section);
-    Solution remoteSolution = getSolution(SolutionPathType::Remote, section);
-    if (remoteSolution.isValid()
-        && mergeSolution(localSolution, SolutionPathType::Remote, remoteSolution)) {
-        totalPage->setSuccess();
-    } else {
+    // The solution is sent by the sync, its outcome is shown once it ends
+    if (remoteSync->state() == RemoteSync::State::Disabled) {
         QMessageBox::warning(this, "Ошибка при сохранении",
                              "Не удалось сохранить ответ на сервере. "
                              "Нет доступа к папке для ответов.");
+        return;
     }
+    isTransferRequested = true;
+    remoteSync->sync();
 }
 
 void TrainingForm::createSolutionArchive(QString path)
@@ -293,19 +256,98 @@ void TrainingForm::createSolutionArchive(QString path)
     showInExplorer(path);
 }
 
-void TrainingForm::openQuestionPage(int pageId)
+QuestionPage* TrainingForm::questionPage(QListWidgetItem* caseItem)
+{
+    auto& node = nodes[caseItem];
+    if (node.questionPage)
+        return node.questionPage;
+
+    QuestionPage* page = new QuestionPage;
+    if (!page->loadCase(section, node.caseValue)) {
+        delete page;
+        return nullptr;
+    }
+    ui->stackedWidget->addWidget(page);
+    page->connectWith(caseItem);
+    connect(page, SIGNAL(enteredAnswer(QListWidgetItem*)),
+            this, SLOT(onAnswerEntered(QListWidgetItem*)));
+    connect(page, SIGNAL(requestedMentorAnswer(QListWidgetItem*)),
+            this, SLOT(toMentorAnswer(QListWidgetItem*)));
+    node.questionPage = page;
+    return page;
+}
+
+MentorAnswerPage* TrainingForm::mentorAnswerPage(QListWidgetItem* caseItem)
+{
+    auto& node = nodes[caseItem];
+    if (node.mentorAnswerPage)
+        return node.mentorAnswerPage;
+
+    MentorAnswerPage* page = new MentorAnswerPage;
+    if (!page->loadCase(section, node.caseValue)) {
+        delete page;
+        return nullptr;
+    }
+    ui->stackedWidget->addWidget(page);
+    page->connectWith(caseItem);
+    connect(page, SIGNAL(requestedBack(QListWidgetItem*)),
+            this, SLOT(backToQuestion(QListWidgetItem*)));
+    connect(page, SIGNAL(requestedNext(QListWidgetItem*)),
+            this, SLOT(next(QListWidgetItem*)));
+    node.mentorAnswerPage = page;
+    return page;
+}
+
+void TrainingForm::openQuestionPage(QListWidgetItem* caseItem)
 {
-    QuestionPage* page = (QuestionPage*)ui->stackedWidget->widget(pageId);
+    if (!nodes.contains(caseItem))
+        return;
+    QuestionPage* page = questionPage(caseItem);
+    if (!page) {
+        QMessageBox::warning(this, "Ошибка при загрузке",
+                             "Не удалось загрузить вопрос кейса \""
+                             + nodes[caseItem].caseValue.name + "\".");
+        return;
+    }
     page->onPageOpened();
-    ui->stackedWidget->setCurrentIndex(pageId);
+    ui->stackedWidget->setCurrentWidget(page);
+}
+
+void TrainingForm::openMentorAnswerPage(QListWidgetItem* caseItem)
+{
+    if (!nodes.contains(caseItem))
+        return;
+    MentorAnswerPage* page = mentorAnswerPage(caseItem);
+    if (!page) {
+        QMessageBox::warning(this, "Ошибка при загрузке",
+                             "Не удалось загрузить ответ наставника для кейса \""
+                             + nodes[caseItem].caseValue.name + "\".");
+        return;
+    }
+    ui->stackedWidget->setCurrentWidget(page);
+}
+
+void TrainingForm::updateCaseIcon(QUuid caseId)
+{
+    Solution solution = peekSolution(SolutionPathType::Local, section);
+    for (auto it = nodes.cbegin(); it != nodes.cend(); ++it) {
+        if (it->caseValue.id != caseId)
+            continue;
+        bool isAnswered = solution.isValid() && solution.answer(it->caseValue).isFinal();
+        it.key()->setIcon(QIcon(isAnswered ? ":/icons/answered.png" : ":/icons/question.png"));
+        return;
+    }
+}
+
+bool TrainingForm::isRemoteSaved() const
+{
+    // Answers that can not be written to the remote dir wait in the outbox
+    return Settings::instance().answerType() == TrainingAnswerType::RemoteDir;
 }
 
 bool TrainingForm::isSectionCompleted() const
 {
-    Solution solution = getSolution(SolutionPathType::Local, section);
-    if (!solution.isValid())
-        return false;
-    return solution.finalAnswersNum() == section.cases.size();
+    return getCompletionStats(section).isCompleted;
 }
 
 void TrainingForm::updateTotal()
@@ -325,23 +367,43 @@ void TrainingForm::updateTotal()
         totalItem->setIcon(QIcon(":/icons/total.png"));
     }
 
-    if (Settings::instance().answerType() == TrainingAnswerType::RemoteDir) {
-        Solution localSolution = getSolution(SolutionPathType::Local, section);
-        Solution remoteSolution = getSolution(SolutionPathType::Remote, section);
-        if (remoteSolution.isValid()) {
-            if (localSolution.answers.size() == remoteSolution.answers.size()) {
-                totalPage->setSuccess();
-            } else {
-                if (mergeSolution(localSolution, SolutionPathType::Remote, remoteSolution)) {
-                    totalPage->setSuccess();
-                } else {
-                    totalPage->setTransferError();
-                }
-            }
-        } else {
-            totalPage->setTransferError();
-        }
-    } else {
+    // Solutions are sent to the remote dir by the sync on its own thread,
+    // the page only shows how far it got
+    if (Settings::instance().answerType() == TrainingAnswerType::RemoteDir
+        && remoteSync->state() != RemoteSync::State::Disabled && !isRemoteComplete())
+        remoteSync->sync();
+    updateTransferState();
+    updatePendingAnswers();
+}
+
+void TrainingForm::updateTransferState()
+{
+    if (!totalPage)
+        return;
+    if (Settings::instance().answerType() != TrainingAnswerType::RemoteDir) {
         totalPage->setUnknownState();
+        return;
     }
+
+    auto state = remoteSync->state();
+    if (isRemoteComplete()) {
+        totalPage->setSuccess();
+    } else if (state != RemoteSync::State::Syncing) {
+        totalPage->setTransferError();
+        if (isTransferRequested) {
+            QMessageBox::warning(this, "Ошибка при сохранении",
+                                 "Не удалось сохранить ответ на сервере. "
+                                 "Нет доступа к папке для ответов.");
+        }
+    }
+    if (state != RemoteSync::State::Syncing)
+        isTransferRequested = false;
+}
+
+bool TrainingForm::isRemoteComplete() const
+{
+    Solution localSolution = peekSolution(SolutionPathType::Local, section);
+    Solution remoteSolution = peekSolution(SolutionPathType::Remote, section);
+    return remoteSolution.isValid()
+            && localSolution.answers().size() == remoteSolution.answers().size();
 }
@@ -12,14 +12,18 @@ class TrainingForm;
 }
 
 class QListWidgetItem;
+class QuestionPage;
+class MentorAnswerPage;
 class TotalPage;
+class SaveQueue;
+class RemoteSync;
 
 class TrainingForm : public QWidget
 {
     Q_OBJECT
 
 public:
-    explicit TrainingForm(QWidget *parent = 0);
+    TrainingForm(SaveQueue* saveQueue, RemoteSync* remoteSync, QWidget *parent = 0);
     ~TrainingForm();
 
     bool setSection(const Section& section);
@@ -33,6 +37,10 @@ private slots:
     void on_listWidget_itemSelectionChanged();
     void on_startButton_clicked();
     void onAnswerEntered(QListWidgetItem* caseItem);
+    void onAnswerSaved(QUuid sectionId, QUuid caseId);
+    void onAnswerSaveFailed(QUuid sectionId, QUuid caseId);
+    void updatePendingAnswers();
+    void updateTransferState();
     void toMentorAnswer(QListWidgetItem* caseItem);
     void backToQuestion(QListWidgetItem* caseItem);
     void next(QListWidgetItem* caseItem);
@@ -40,15 +48,26 @@ private slots:
     void createSolutionArchive(QString path);
 
 private:
-    void openQuestionPage(int pageId);
+    QuestionPage* questionPage(QListWidgetItem* caseItem);
+    MentorAnswerPage* mentorAnswerPage(QListWidgetItem* caseItem);
+    void openQuestionPage(QListWidgetItem* caseItem);
+    void openMentorAnswerPage(QListWidgetItem* caseItem);
+    void updateCaseIcon(QUuid caseId);
+    bool isRemoteSaved() const;
+    bool isRemoteComplete() const;
     bool isSectionCompleted() const;
     void updateTotal();
 
     Ui::TrainingForm *ui;
+    SaveQueue* saveQueue;
+    RemoteSync* remoteSync;
+    bool isTransferRequested = false;
 
+    // Pages are created on the first visit of the case
     struct NodeDescriptor {
-        int questionPageId;
-        int mentorAnswerPageId;
+        Case caseValue;
+        QuestionPage* questionPage;
+        MentorAnswerPage* mentorAnswerPage;
         QListWidgetItem* nextItem;
     };
 
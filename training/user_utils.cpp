@@ -1,25 +1,31 @@
 #include "user_utils.h"
 #include <QDir>
+#include <QMutex>
 
 namespace {
 QString userNameValue;
+// Remote sync reads the name on a worker thread
+QMutex userNameMutex;
 }
 
 QString userName()
 {
+    QMutexLocker locker(&userNameMutex);
     return userNameValue;
 }
 
 void setUserName(QString name)
 {
+    QMutexLocker locker(&userNameMutex);
     userNameValue = name;
 }
 
 QString getUserPath(QString path)
 {
+    QString name = userName();
     QDir dir(path);
-    if (!dir.exists(userNameValue))
-        if (!dir.mkdir(userNameValue))
+    if (!dir.exists(name))
+        if (!dir.mkdir(name))
             return QString();
-    return dir.absoluteFilePath(userNameValue);
+    return dir.absoluteFilePath(name);
 }